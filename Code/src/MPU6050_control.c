@@ -11,6 +11,12 @@
  * and read measurements produced from the device.  Can read raw values for
  * accelerometer, gyroscope and temperature sensor.
  *
+ * The accel and gyro are sampled in the background and averaged down to the
+ * rate the filters need.  In data ready mode the INT pin of the MPU6050 
+ * starts a read of every new sample and stamps it.  In FIFO mode the 
+ * MPU6050 queues the samples in its FIFO and MPUSamplePoll reads them in 
+ * bursts.
+ *
  */
 
 /*----------------------------------------------------------------------------*/
@@ -19,6 +25,8 @@
 #include "common.h"
 #include "MPU6050_control.h"
 #include "i2c.h"
+#include "timebase.h"
+#include "power.h"
 
 /*----------------------------------------------------------------------------*/
 /* MACROS                                                                     */
@@ -591,6 +599,25 @@
 // Default I2C address for the MPU-6050 is 0x68.
 #define MPU6050_I2C_ADDRESS 0x68
 
+// FIFO mode
+#define MPU_FIFO_SIZE     1024    /* bytes                                   */
+#define MPU_FIFO_RECORD   12      /* accel x,y,z then gyro x,y,z, big-endian */
+#define MPU_DRDY_RECORD   14      /* accel x,y,z, temperature, gyro x,y,z    */
+#define MPU_SAMPLES       4       /* downsampled samples waiting for a reader*/
+#define MPU_SAMPLE_US     8000UL  /* 125Hz sample period in us               */
+#define MPU_FIFO_PERIOD   (MPU_FIFO_PERIOD_MS * 1000UL)
+
+// Calibration
+#define MPU_ONE_G         16384   /* accel LSB per g at +-2g                 */
+#define MPU_GYRO_LSB      131     /* gyro LSB per deg/s at +-250deg/s        */
+#define MPU_SCALE_ONE     16384   /* accelScale of 1.0                       */
+#define MPU_CAL_SAMPLES   64      /* downsampled samples averaged, about 1s  */
+#define MPU_CAL_STILL     262     /* most gyro spread when still, 2deg/s     */
+#define MPU_CAL_TIMEOUT   3000000UL /* us, 3s                                */
+
+// Temperature
+#define MPU_TEMP_OFFSET   12420   /* 36.53C in TEMP_OUT counts, 340 per C    */
+
 /*----------------------------------------------------------------------------*/
 /* Global Data                                                                */
 /*----------------------------------------------------------------------------*/
@@ -600,15 +627,79 @@ float accelArrayZ[3];
 uint8_t accelIndex;
 int16_t past_temperature;
 
+/* background read behind getTemp */
+uint8_t tempData[2];
+twi_transaction tempRead = {MPU6050_I2C_ADDRESS, MPU6050_TEMP_OUT_H, 
+                            tempData, 2, 1, 0, TWI_IDLE, 0};
+
+/* Sampling, see MPU_SAMPLE_MODE */
+#if MPU_SAMPLE_MODE == MPU_MODE_FIFO
+typedef enum {FIFO_OFF = 0, FIFO_WAIT, FIFO_COUNT, FIFO_DATA} fifo_state_t;
+
+fifo_state_t fifoState = FIFO_OFF;
+uint32_t fifoStamp;             /* timestamp of the last count read     */
+uint32_t fifoRecordStamp;       /* timestamp of the next record read    */
+uint16_t fifoLeft;              /* records in the FIFO not read yet     */
+uint8_t  fifoStatus;            /* INT_STATUS, for the overflow flag    */
+uint8_t  fifoCount[2];          /* FIFO_COUNTH, FIFO_COUNTL             */
+uint8_t  fifoData[MPU_FIFO_BATCH * MPU_FIFO_RECORD];
+uint8_t  fifoControl;           /* USER_CTRL value written on a reset   */
+twi_transaction fifoStatusRead = {MPU6050_I2C_ADDRESS, MPU6050_INT_STATUS, 
+                                  &fifoStatus, 1, 1, 0, TWI_IDLE, 0};
+twi_transaction fifoCountRead = {MPU6050_I2C_ADDRESS, MPU6050_FIFO_COUNTH, 
+                                 fifoCount, 2, 1, 0, TWI_IDLE, 0};
+twi_transaction fifoDataRead = {MPU6050_I2C_ADDRESS, MPU6050_FIFO_R_W, 
+                                fifoData, 0, 1, 0, TWI_IDLE, 0};
+twi_transaction fifoReset = {MPU6050_I2C_ADDRESS, MPU6050_USER_CTRL, 
+                             &fifoControl, 1, 0, 0, TWI_IDLE, 0};
+#else
+uint32_t drdyStamp;             /* when the sample being read was ready */
+uint8_t  drdyData[MPU_DRDY_RECORD];
+twi_transaction drdyRead = {MPU6050_I2C_ADDRESS, MPU6050_ACCEL_XOUT_H, 
+                            drdyData, MPU_DRDY_RECORD, 1, 0, TWI_IDLE, 0};
+#endif
+
+/* downsampling, sums of the samples in the current group.  The ring is 
+   filled from the interrupts in data ready mode, only AddSample moves 
+   sampleHead and only MPUGetSample moves sampleTail. */
+int32_t  sampleSum[6];
+uint8_t  sampleSummed;
+MPU_raw  samples[MPU_SAMPLES];        /* ring of downsampled samples    */
+volatile uint8_t sampleHead = 0;
+volatile uint8_t sampleTail = 0;
+uint16_t samplesLost = 0;             /* overflows, overruns, full ring */
+
+/* TRUE while the MPU6050 only watches for motion, see MPUPark */
+volatile bool_t mpuParked = FALSE;
+
+/* calibration applied to the samples, none until MPUSetCalibration */
+MPU_calibration mpuCal = {{0, 0, 0}, {0, 0, 0}, MPU_SCALE_ONE, 0};
+
+/* calibration running, see MPUCalibrateStart */
+MPU_calibration calSaved;             /* in use before, kept on a failure */
+int32_t  calSum[6];                   /* accel then gyro                  */
+int16_t  calLow[3];                   /* gyro spread                      */
+int16_t  calHigh[3];
+uint8_t  calCount;                    /* samples summed so far            */
+uint32_t calStart;                    /* NowUs() when it started          */
+
 /*----------------------------------------------------------------------------*/
 /* FUNCTIONS                                                                  */
 /*----------------------------------------------------------------------------*/
+static void AddSample(int16_t const* raw, uint32_t stamp);
+static void ApplyCalibration(int16_t* raw);
+#if MPU_SAMPLE_MODE == MPU_MODE_FIFO
+static void FifoRestart(void);
+static void FifoDecode(uint8_t records);
+#else
+static void DataReadyDone(twi_transaction* transaction);
+#endif
 
 void Init_MPU6050()
 {
   TWIInit();
   
-  TWIWriteByte(MPU6050_SMPLRT_DIV, 0x07);        //Sets sample rate to 8000/1+7 = 1000Hz
+  TWIWriteByte(MPU6050_SMPLRT_DIV, 0x07);        //Sets sample rate to 1000/1+7 = 125Hz, the DLPF is on
   uint8_t config1[] = {0x36,0,0,0,0,0,0,0,0,0,0x0D,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
   TWIWriteBurst(MPU6050_I2C_ADDRESS, MPU6050_CONFIG, config1, 28);
   uint8_t config2[] = {0,0,0,0,0,0,0,0,0x02,0};
@@ -620,21 +711,25 @@ void Init_MPU6050()
 MPU_stats GetMPUStats()
 {
   uint8_t data[14];
-  int16_t temp_accel_x, temp_accel_y, temp_accel_z;
+  int16_t raw[6];
+  uint8_t i;
   MPU_stats stats;
   TWIReadBurst(MPU6050_I2C_ADDRESS, MPU6050_ACCEL_XOUT_H, data, 14);
   
-  stats.gyro_x_pos =  ((((uint16_t)data[8])<<8) | data[9]) *0.00763358778;////multiply by the offset
-  stats.gyro_y_pos =  ((((uint16_t)data[10])<<8)| data[11])*0.00763358778;
-  stats.gyro_z_pos =  ((((uint16_t)data[12])<<8)| data[13])*0.00763358778;
+  for(i = 0; i < 3; ++i)
+  {
+    raw[i]   = (int16_t)((((uint16_t)data[2*i])<<8) | data[2*i + 1]);
+    raw[i+3] = (int16_t)((((uint16_t)data[2*i + 8])<<8) | data[2*i + 9]);
+  }
+  ApplyCalibration(raw);
   
-  temp_accel_x= ((((uint16_t)data[0])<<8)| data[1]);
-  temp_accel_y= ((((uint16_t)data[2])<<8)| data[3]);
-  temp_accel_z= ((((uint16_t)data[4])<<8)| data[5]);
-
-  stats.accel_x_pos = (temp_accel_x * 16384);  //multiply by the offset
-  stats.accel_y_pos = (temp_accel_y * 16384);
-  stats.accel_z_pos = (temp_accel_z * 16384);
+  stats.gyro_x_pos = raw[3] / MPU_GYRO_LSB;   //deg/s
+  stats.gyro_y_pos = raw[4] / MPU_GYRO_LSB;
+  stats.gyro_z_pos = raw[5] / MPU_GYRO_LSB;
+  
+  stats.accel_x_pos = raw[0] / (float)MPU_ONE_G;  //g
+  stats.accel_y_pos = raw[1] / (float)MPU_ONE_G;
+  stats.accel_z_pos = raw[2] / (float)MPU_ONE_G;
 
   stats.temperature = ((((uint16_t)data[6])<<8)| data[7]);
   stats.temperature = (stats.temperature/340)+37;
@@ -644,14 +739,443 @@ MPU_stats GetMPUStats()
 int16_t getTemp()
 {
   int16_t temperature;
-  uint8_t data[2];
-  TWIReadBurst(MPU6050_I2C_ADDRESS, MPU6050_ACCEL_XOUT_H, data, 2);
-  temperature = ((((int16_t)data[0])<<8)| (int8_t)data[1]);
-  if (temperature >= -340)
-    return past_temperature;
-  temperature = (temperature/340)+56;
-  past_temperature = temperature;
-  return temperature;
+  
+  /* decode the last read, if there is one, and queue the next.  The 
+     datasheet gives degrees C as TEMP_OUT/340 + 36.53. */
+  if(tempRead.state == TWI_DONE)
+  {
+    temperature = (int16_t)((((uint16_t)tempData[0])<<8) | tempData[1]);
+    past_temperature = (int16_t)(((int32_t)temperature + MPU_TEMP_OFFSET) / 340);
+  }
+  if(tempRead.state != TWI_QUEUED && tempRead.state != TWI_BUSY)
+    TWISubmit(&tempRead);
+  
+  return past_temperature;
+}
+
+void MPUStartSampling()
+{
+  uint8_t i;
+  
+  for(i = 0; i < 6; ++i)
+    sampleSum[i] = 0;
+  sampleSummed = 0;
+  sampleHead = sampleTail;
+  
+#if MPU_SAMPLE_MODE == MPU_MODE_FIFO
+  TWIWriteByte(MPU6050_FIFO_EN, (1<<MPU6050_ACCEL_FIFO_EN)|(1<<MPU6050_XG_FIFO_EN)
+                               |(1<<MPU6050_YG_FIFO_EN)|(1<<MPU6050_ZG_FIFO_EN));
+  TWIWriteByte(MPU6050_USER_CTRL, (1<<MPU6050_FIFO_EN_bit)|(1<<MPU6050_FIFO_RESET));
+  TWIReadByte(MPU6050_INT_STATUS);    /* clears a stale overflow flag */
+  fifoStamp = NowUs();
+  fifoState = FIFO_WAIT;
+#else
+  /* INT is active high, push-pull and pulses for 50us on every sample */
+  drdyRead.callback = DataReadyDone;
+  TWIWriteByte(MPU6050_INT_PIN_CFG, 0x00);
+  TWIWriteByte(MPU6050_INT_ENABLE, (1<<MPU6050_DATA_RDY_EN));
+  
+  DDRE &= ~(1<<4);
+  EICRB |= ((1<<ISC41) | (1<<ISC40));  // Set to activate on rising edge
+  EIFR = (1<<INTF4);
+  EIMSK |= (1<<INT4);                  // Turn on INT4 (MPU6050)
+#endif
+}
+
+void MPUStopSampling()
+{
+#if MPU_SAMPLE_MODE == MPU_MODE_FIFO
+  while(fifoState == FIFO_COUNT || fifoState == FIFO_DATA)
+    MPUSamplePoll();                  /* let the running read finish */
+  fifoState = FIFO_OFF;
+  TWIWriteByte(MPU6050_USER_CTRL, 0x00);
+  TWIWriteByte(MPU6050_FIFO_EN, 0x00);
+#else
+  EIMSK &= ~(1<<INT4);
+  while(drdyRead.state == TWI_QUEUED || drdyRead.state == TWI_BUSY);
+  TWIWriteByte(MPU6050_INT_ENABLE, 0x00);
+#endif
+}
+
+void MPUPark()
+{
+  MPUStopSampling();
+  
+  /* accel only: the gyros in standby, the accel woken at 10Hz for one 
+     sample and compared with the 5Hz high pass reference */
+  TWIWriteByte(MPU6050_ACCEL_CONFIG, (1<<MPU6050_ACCEL_HPF0));
+  TWIWriteByte(MPU6050_MOT_THR, PARK_MOTION_THR);
+  TWIWriteByte(MPU6050_MOT_DUR, PARK_MOTION_DUR);
+  TWIWriteByte(MPU6050_PWR_MGMT_2, (1<<MPU6050_LP_WAKE_CTRL1)|(1<<MPU6050_LP_WAKE_CTRL0)
+                          |(1<<MPU6050_STBY_XG)|(1<<MPU6050_STBY_YG)|(1<<MPU6050_STBY_ZG));
+  TWIWriteByte(MPU6050_PWR_MGMT_1, (1<<MPU6050_CYCLE)|(1<<MPU6050_TEMP_DIS));
+  
+  /* INT is active low and latched until INT_STATUS is read, only a low 
+     level on INT4 can wake the AtMega128 from power down */
+  TWIWriteByte(MPU6050_INT_PIN_CFG, (1<<MPU6050_INT_LEVEL)|(1<<MPU6050_LATCH_INT_EN));
+  TWIWriteByte(MPU6050_INT_ENABLE, (1<<MPU6050_MOT_EN));
+  TWIReadByte(MPU6050_INT_STATUS);
+  
+  mpuParked = TRUE;
+  DDRE &= ~(1<<4);
+  EICRB &= ~((1<<ISC41) | (1<<ISC40)); // Set to activate on low level
+  EIFR = (1<<INTF4);
+  EIMSK |= (1<<INT4);
+}
+
+void MPUUnpark()
+{
+  EIMSK &= ~(1<<INT4);
+  mpuParked = FALSE;
+  
+  TWIWriteByte(MPU6050_INT_ENABLE, 0x00);
+  TWIReadByte(MPU6050_INT_STATUS);    /* releases INT */
+  TWIWriteByte(MPU6050_INT_PIN_CFG, 0x00);
+  TWIWriteByte(MPU6050_PWR_MGMT_1, 0x02);
+  TWIWriteByte(MPU6050_PWR_MGMT_2, 0x00);
+  TWIWriteByte(MPU6050_ACCEL_CONFIG, 0x00);
+  
+  MPUStartSampling();
+}
+
+#if MPU_SAMPLE_MODE == MPU_MODE_FIFO
+void MPUSamplePoll()
+{
+  uint32_t now;
+  uint16_t count;
+  uint8_t records;
+  
+  switch(fifoState)
+  {
+  case FIFO_OFF:
+    break;
+    
+  case FIFO_WAIT:
+    now = NowUs();
+    if(now - fifoStamp < MPU_FIFO_PERIOD)
+      break;
+    
+    /* status and count back to back, the status read clears the flag */
+    fifoStamp = now;
+    TWISubmit(&fifoStatusRead);
+    TWISubmit(&fifoCountRead);
+    fifoState = FIFO_COUNT;
+    break;
+    
+  case FIFO_COUNT:
+    if(TWIFinished(&fifoCountRead) != TRUE || TWIFinished(&fifoStatusRead) != TRUE)
+      break;
+    if(fifoCountRead.state != TWI_DONE || fifoStatusRead.state != TWI_DONE)
+    {
+      fifoState = FIFO_WAIT;          /* bus fault, try again next period */
+      break;
+    }
+    
+    count = (((uint16_t)fifoCount[0])<<8) | fifoCount[1];
+    if((fifoStatus & (1<<MPU6050_FIFO_OFLOW_INT)) || count >= MPU_FIFO_SIZE)
+    {
+      /* samples were lost and the records no longer start on a boundary */
+      samplesLost++;
+      FifoRestart();
+      fifoState = FIFO_WAIT;
+      break;
+    }
+    
+    /* the newest record was taken about when the count was read, the 
+       ones before it one sample period apart */
+    fifoLeft = count / MPU_FIFO_RECORD;
+    if(fifoLeft != 0)
+      fifoRecordStamp = fifoStamp - (uint32_t)(fifoLeft - 1) * MPU_SAMPLE_US;
+    /* fall through */
+    
+  case FIFO_DATA:
+    if(fifoState == FIFO_DATA)
+    {
+      if(TWIFinished(&fifoDataRead) != TRUE)
+        break;
+      if(fifoDataRead.state != TWI_DONE)
+      {
+        FifoRestart();                /* part of a record may be gone */
+        fifoState = FIFO_WAIT;
+        break;
+      }
+      FifoDecode(fifoDataRead.length / MPU_FIFO_RECORD);
+    }
+    
+    if(fifoLeft == 0)
+    {
+      fifoState = FIFO_WAIT;
+      break;
+    }
+    records = (fifoLeft > MPU_FIFO_BATCH) ? MPU_FIFO_BATCH : (uint8_t)fifoLeft;
+    fifoLeft -= records;
+    fifoDataRead.length = records * MPU_FIFO_RECORD;
+    TWISubmit(&fifoDataRead);
+    fifoState = FIFO_DATA;
+    break;
+  }
+}
+
+/* Empties the FIFO and starts the averaging over */
+static void FifoRestart(void)
+{
+  uint8_t i;
+  
+  fifoControl = (1<<MPU6050_FIFO_EN_bit)|(1<<MPU6050_FIFO_RESET);
+  TWISubmit(&fifoReset);
+  for(i = 0; i < 6; ++i)
+    sampleSum[i] = 0;
+  sampleSummed = 0;
+}
+
+/* Feeds the records read from the FIFO to the downsampling */
+static void FifoDecode(uint8_t records)
+{
+  uint8_t const* record = fifoData;
+  int16_t raw[6];
+  uint8_t i;
+  
+  while(records--)
+  {
+    for(i = 0; i < 6; ++i)
+      raw[i] = (int16_t)((((uint16_t)record[2*i])<<8) | record[2*i + 1]);
+    AddSample(raw, fifoRecordStamp);
+    fifoRecordStamp += MPU_SAMPLE_US;
+    record += MPU_FIFO_RECORD;
+  }
+}
+#else
+void MPUSamplePoll()
+{
+  /* data ready mode runs from the interrupts */
+}
+
+/* Called from the TWI interrupt once a sample has been read, the 
+   temperature in the middle of the record is skipped */
+static void DataReadyDone(twi_transaction* transaction)
+{
+  int16_t raw[6];
+  uint8_t i;
+  
+  if(transaction->state != TWI_DONE)
+  {
+    samplesLost++;
+    return;
+  }
+  for(i = 0; i < 3; ++i)
+  {
+    raw[i]   = (int16_t)((((uint16_t)drdyData[2*i])<<8) | drdyData[2*i + 1]);
+    raw[i+3] = (int16_t)((((uint16_t)drdyData[2*i + 8])<<8) | drdyData[2*i + 9]);
+  }
+  AddSample(raw, drdyStamp);
+  WAKE_MAIN();
+}
+#endif
+
+/* interrupt located on PINE4 and is connected to the INT pin of the MPU6050,
+   it uses INT_4 vector.  While parked it is the motion interrupt that wakes
+   the CPU from power down.  In data ready mode it starts reading a sample as
+   soon as it is ready, if the last read has not finished yet the new sample
+   is skipped.*/
+#pragma vector= INT4_vect
+__interrupt void ISR_INT4()
+{
+  if(mpuParked == TRUE)
+  {
+    /* INT stays low until MPUUnpark reads INT_STATUS and the low level 
+       interrupt would fire again straight away */
+    EIMSK &= ~(1<<INT4);
+    WAKE_FROM_PARK();
+    WAKE_MAIN();
+    return;
+  }
+#if MPU_SAMPLE_MODE == MPU_MODE_DATA_READY
+  if(drdyRead.state == TWI_QUEUED || drdyRead.state == TWI_BUSY)
+  {
+    samplesLost++;
+    return;
+  }
+  drdyStamp = NowUs();
+  TWISubmit(&drdyRead);
+#endif
+}
+
+/* Adds one sample to the downsampling.  Every 2^MPU_DECIMATE_SHIFT samples
+   the average goes into the output ring with the timestamp of the newest 
+   one, it is dropped if the reader is behind. */
+static void AddSample(int16_t const* raw, uint32_t stamp)
+{
+  uint8_t next;
+  uint8_t i;
+  
+  for(i = 0; i < 6; ++i)
+    sampleSum[i] += raw[i];
+  if(++sampleSummed < (1<<MPU_DECIMATE_SHIFT))
+    return;
+  
+  next = (sampleHead + 1) & (MPU_SAMPLES - 1);
+  if(next == sampleTail)
+    samplesLost++;
+  else
+  {
+    int16_t average[6];
+    
+    for(i = 0; i < 6; ++i)
+      average[i] = (int16_t)(sampleSum[i] >> MPU_DECIMATE_SHIFT);
+    ApplyCalibration(average);
+    samples[sampleHead].accel_x = average[0];
+    samples[sampleHead].accel_y = average[1];
+    samples[sampleHead].accel_z = average[2];
+    samples[sampleHead].gyro_x  = average[3];
+    samples[sampleHead].gyro_y  = average[4];
+    samples[sampleHead].gyro_z  = average[5];
+    samples[sampleHead].stamp   = stamp;
+    sampleHead = next;
+  }
+  
+  for(i = 0; i < 6; ++i)
+    sampleSum[i] = 0;
+  sampleSummed = 0;
+}
+
+bool_t MPUGetSample(MPU_raw* sample)
+{
+  if(sampleTail == sampleHead)
+    return FALSE;
+  *sample = samples[sampleTail];
+  sampleTail = (sampleTail + 1) & (MPU_SAMPLES - 1);
+  return TRUE;
+}
+
+__monitor uint16_t MPUSamplesLost()
+{
+  return samplesLost;
+}
+
+/* Removes the biases and scales the accel axes, accel then gyro in raw.
+   Called from the TWI interrupt in data ready mode, mpuCal is only changed
+   with interrupts off. */
+static void ApplyCalibration(int16_t* raw)
+{
+  int32_t accel;
+  uint8_t i;
+  
+  for(i = 0; i < 3; ++i)
+  {
+    accel = (((int32_t)raw[i] - mpuCal.accelBias[i]) * mpuCal.accelScale) >> 14;
+    if(accel > 32767)
+      accel = 32767;
+    else if(accel < -32768)
+      accel = -32768;
+    raw[i] = (int16_t)accel;
+    raw[i+3] -= mpuCal.gyroBias[i];
+  }
+}
+
+__monitor void MPUSetCalibration(MPU_calibration const* calibration)
+{
+  mpuCal = *calibration;
+}
+
+void MPUCalibrateStart()
+{
+  MPU_calibration none = {{0, 0, 0}, {0, 0, 0}, MPU_SCALE_ONE, 0};
+  MPU_raw sample;
+  uint8_t i;
+  
+  calSaved = mpuCal;
+  MPUSetCalibration(&none);
+  while(MPUGetSample(&sample) == TRUE);   /* drop samples from before */
+  
+  for(i = 0; i < 6; ++i)
+    calSum[i] = 0;
+  for(i = 0; i < 3; ++i)
+  {
+    calLow[i] = 32767;
+    calHigh[i] = -32768;
+  }
+  calCount = 0;
+  calStart = NowUs();
+}
+
+/* Works the result out of the sums once every sample is in */
+static mpu_cal_t CalibrateFinish(MPU_calibration* calibration)
+{
+  int32_t mean;
+  uint32_t up = 0;
+  uint8_t upAxis = 0;
+  uint8_t i;
+  
+  for(i = 0; i < 3; ++i)
+  {
+    if((int32_t)calHigh[i] - calLow[i] > MPU_CAL_STILL)
+    {
+      MPUSetCalibration(&calSaved);       /* the bike was moving */
+      return MPU_CAL_FAILED;
+    }
+  }
+  
+  /* Gravity is on the axis with the largest reading.  Its average sets the
+     gain, the other two axes should read 0 on level ground. */
+  for(i = 0; i < 3; ++i)
+  {
+    mean = calSum[i] / MPU_CAL_SAMPLES;
+    calibration->gyroBias[i] = (int16_t)(calSum[i+3] / MPU_CAL_SAMPLES);
+    calibration->accelBias[i] = (int16_t)mean;
+    if(mean < 0)
+      mean = -mean;
+    if((uint32_t)mean > up)
+    {
+      up = mean;
+      upAxis = i;
+    }
+  }
+  if(up < MPU_ONE_G / 2)
+  {
+    MPUSetCalibration(&calSaved);         /* no gravity, not a real reading */
+    return MPU_CAL_FAILED;
+  }
+  calibration->accelBias[upAxis] = 0;
+  calibration->accelScale = (uint16_t)(((uint32_t)MPU_ONE_G * MPU_SCALE_ONE) / up);
+  calibration->valid = MPU_CAL_VALID;
+  
+  MPUSetCalibration(calibration);
+  return MPU_CAL_DONE;
+}
+
+mpu_cal_t MPUCalibratePoll(MPU_calibration* calibration)
+{
+  MPU_raw sample;
+  int16_t g;
+  uint8_t i;
+  
+  while(calCount < MPU_CAL_SAMPLES && MPUGetSample(&sample) == TRUE)
+  {
+    calSum[0] += sample.accel_x;
+    calSum[1] += sample.accel_y;
+    calSum[2] += sample.accel_z;
+    calSum[3] += sample.gyro_x;
+    calSum[4] += sample.gyro_y;
+    calSum[5] += sample.gyro_z;
+    for(i = 0; i < 3; ++i)
+    {
+      g = (i == 0) ? sample.gyro_x : (i == 1) ? sample.gyro_y : sample.gyro_z;
+      if(g < calLow[i])
+        calLow[i] = g;
+      if(g > calHigh[i])
+        calHigh[i] = g;
+    }
+    calCount++;
+  }
+  
+  if(calCount == MPU_CAL_SAMPLES)
+    return CalibrateFinish(calibration);
+  if(NowUs() - calStart > MPU_CAL_TIMEOUT)
+  {
+    MPUSetCalibration(&calSaved);         /* no samples, sensor missing */
+    return MPU_CAL_FAILED;
+  }
+  return MPU_CAL_RUNNING;
 }
   
-/** @} */ /* MPU6050_control */
\ No newline at end of file
+/** @} */ /* MPU6050_control */
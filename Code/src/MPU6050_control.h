@@ -46,6 +46,31 @@
 
     } MPU_stats;
 
+    /* one sample in LSB counts, as read from the sensor */
+    typedef struct
+    {
+      int16_t accel_x;
+      int16_t accel_y;
+      int16_t accel_z;
+      int16_t gyro_x;
+      int16_t gyro_y;
+      int16_t gyro_z;
+      uint32_t stamp;  /* NowUs() when it was taken */
+    } MPU_raw;
+
+    /* biases and gain found by MPUCalibratePoll, kept in EEprom */
+    #define MPU_CAL_VALID 0xA5
+    typedef struct
+    {
+      int16_t  accelBias[3];  /* LSB, removed before scaling      */
+      int16_t  gyroBias[3];   /* LSB                              */
+      uint16_t accelScale;    /* accel gain, 16384 is 1.0         */
+      uint8_t  valid;         /* MPU_CAL_VALID once calibrated    */
+    } MPU_calibration;
+
+    /* progress of MPUCalibratePoll */
+    typedef enum {MPU_CAL_RUNNING, MPU_CAL_DONE, MPU_CAL_FAILED} mpu_cal_t;
+
     typedef struct
     {
       float x_pos;
@@ -72,8 +97,8 @@ void Init_MPU6050();
 /** A function used to get the Accelerometer, Gyroscope and temperature values
  *  from the appropriate registers. This function will read all the data in 
  *  each register and place it in a Structure for easy use.  This function will
- *  also add any offsets into the raw values received in order to make it 
- *  useful.
+ *  also apply the calibration and convert the accel to g and the gyro to 
+ *  deg/s.
  *		
  *	@returns
  *			-Returns the MPU_stats structure stats, containing temperature, 
@@ -82,12 +107,103 @@ void Init_MPU6050();
  */
 MPU_stats GetMPUStats();
 
-/** A function used to get the temperature from the MPU6050's register.
+/** A function used to get the temperature from the MPU6050's register.  The
+ *  register is read in the background, so the value returned is the one 
+ *  read after the previous call and the caller never waits on the bus.
  *  	
  *	@returns
- *			-Returns the temperature value from the MPU6050.
+ *			-Returns the temperature of the MPU6050 in degrees C.
  */
 int16_t getTemp();
 
+/** A function used to start sampling in the mode set by MPU_SAMPLE_MODE.
+ *  In data ready mode it enables the data ready interrupt of the MPU6050 
+ *  and INT4 on PORTE 4, in FIFO mode it enables the FIFO for the accel and 
+ *  gyro samples and empties it.  The downsampling starts over.
+ */
+void MPUStartSampling();
+
+/** A function used to stop sampling.  Waits for a read that is still 
+ *  running and disables the interrupt or the FIFO.
+ */
+void MPUStopSampling();
+
+/** A function that reads the FIFO in the background in FIFO mode.  Every 
+ *  MPU_FIFO_PERIOD_MS it reads the overflow flag and the FIFO count, then
+ *  the samples in bursts of up to MPU_FIFO_BATCH.  On an overflow the FIFO
+ *  is emptied, since the records no longer start on a boundary.  Has to be
+ *  called from the main loop, never waits on the bus.  Does nothing in data
+ *  ready mode.
+ */
+void MPUSamplePoll();
+
+/** A function used to get the next downsampled sample.
+ *
+ *	@par Parameters
+ *			-@a sample = filled in with the average of 2^MPU_DECIMATE_SHIFT
+ *			             samples, in LSB counts, and the timestamp of the
+ *			             newest of them.
+ *  	
+ *	@returns
+ *			-Returns TRUE when there was a new sample.
+ */
+bool_t MPUGetSample(MPU_raw* sample);
+
+/** A function used to get the number of samples lost.
+ *  	
+ *	@returns
+ *			-Returns how many times samples were lost to a FIFO overflow, a
+ *			 read that was still running or a reader that fell behind.
+ */
+uint16_t MPUSamplesLost();
+
+/** A function used to set the calibration applied to every sample.
+ *
+ *	@par Parameters
+ *			-@a calibration = biases and gain, e.g. from MPUCalibratePoll or
+ *			                  EEprom.
+ */
+void MPUSetCalibration(MPU_calibration const* calibration);
+
+/** A function used to start calibrating the MPU6050.  Averages 
+ *  MPU_CAL_SAMPLES samples, about one second, with the bike standing still
+ *  on level ground.  The averages of the gyro are its biases.  Gravity pulls
+ *  on the accel axis with the largest reading, its average sets the gain of
+ *  all three axes and the other two averages are their biases.  Returns 
+ *  straight away, MPUCalibratePoll() takes the samples.  Needs sampling to
+ *  be running and nothing else may take the samples meanwhile.
+ */
+void MPUCalibrateStart();
+
+/** A function used to run the calibration started by MPUCalibrateStart(),
+ *  called from the main loop until it is over.  Gives up after 
+ *  MPU_CAL_TIMEOUT, 3 seconds.
+ *
+ *	@par Parameters
+ *			-@a calibration = filled in with the result once it is done.
+ *  	
+ *	@returns
+ *			-Returns MPU_CAL_DONE and applies the result when it worked,
+ *			 MPU_CAL_FAILED when the bike moved or no samples came in, the
+ *			 calibration in use is kept then, and MPU_CAL_RUNNING until
+ *			 either.
+ */
+mpu_cal_t MPUCalibratePoll(MPU_calibration* calibration);
+
+/** A function used to park the MPU6050.  Sampling stops, the gyros go to
+ *  standby and the accel wakes at 10Hz to compare one sample against the 
+ *  high pass filtered reference.  Motion above PARK_MOTION_THR pulls INT
+ *  low, which is INT4 on PORTE 4 set to trigger on a low level so it can 
+ *  wake the AtMega128 from power down.  The interrupt calls 
+ *  WAKE_FROM_PARK().
+ */
+void MPUPark();
+
+/** A function used to bring the MPU6050 back from MPUPark.  Clears the 
+ *  motion interrupt, restores the registers Init_MPU6050 set and starts
+ *  sampling again.
+ */
+void MPUUnpark();
+
 #endif /* MPU6050_control_H */ 
 /** @} */ /* MPU6050_control */
@@ -8,7 +8,13 @@
  *
  * This source file provides the functions used to read and write to the  
  * bluetooth module.  Contains functions for initialization along with reset
- * and an interrupt service routine for input data.
+ * and an interrupt service routine for input data.  The interrupt only 
+ * queues the command bytes, they are answered from the main loop by 
+ * BluetoothPoll.
+ *
+ * Instead of polling one field at a time the app can subscribe to a 
+ * telemetry stream.  Timer3 paces the frames, BluetoothPoll builds and 
+ * queues them.
  */
 
 /*----------------------------------------------------------------------------*/
@@ -17,6 +23,11 @@
 #include "bluetooth.h"
 #include "user_config.h"
 #include "uart.h"
+#include "hall_effect.h"
+#include "power.h"
+#include "scheduler.h"
+#include "gearing.h"
+#include "learn.h"
 //#include <stdio.h>
 #include TARGET_HEADER
 #include INTRINSICS_HEADER
@@ -31,15 +42,42 @@
 #define GEARS       'g'
 #define WARNING     'w'
 #define POWER_STATS 'p'
+#define SUBSCRIBE   'S'   /* followed by the rate in Hz, 0 to stop */
+#define CALIBRATE   'C'   /* recalibrate the MPU6050 once stopped  */
+#define DUTY_CYCLE  'd'   /* percent of time awake since last asked */
+#define WAKE_TIME   'l'   /* last wake from parking to ready, us    */
+#define TASK_TIMES  'r'   /* run times and start delay of each task */
+#define SET_BAND    'B'   /* followed by the low and high cadence   */
+#define BAND        'b'   /* cadence band of automatic mode, rpm    */
+#define FORGET      'L'   /* forget the cadences learned            */
+
+/*----------------------------------------------------------------------------*/
+/* Defines                                                                    */
+/*----------------------------------------------------------------------------*/
+#define RX_SIZE     16  /* command ring size, power of 2 */
+#define ACK         0x06  /* reply to a setting that was taken   */
+#define NACK        0x15  /* reply to a setting that was refused */
+
+/* bytes that follow a command */
+#define COMMAND_ARGS(cmd)  ((cmd) == SUBSCRIBE ? 1 : (cmd) == SET_BAND ? 2 : 0)
+
+#define TELEMETRY_SYNC      0xA5
+#define TELEMETRY_FRAME     13     /* bytes per frame, see BuildFrame      */
+#define TELEMETRY_MAX_RATE  20     /* Hz                                   */
+#define TELEMETRY_TIMER_HZ  62500  /* Timer3 counts, 16MHz / 256           */
+
 /*----------------------------------------------------------------------------*/
 /* External Functions                                                         */
 /*----------------------------------------------------------------------------*/
-extern float GetSpeed();
-extern float GetCadence();
+extern ufix8_8_t GetSpeed();
+extern ufix8_8_t GetCadence();
 extern int16_t getTemp(void);
 extern uint8_t GetFrontGear();
 extern uint8_t GetRearGear();
 extern uint8_t GetWarning(void);
+extern power_stats GetPowerStats(void);
+extern void RequestCalibration(void);
+extern uint16_t GetWakeLatency(void);
 
 /*----------------------------------------------------------------------------*/
 /* Datastructures                                                             */
@@ -50,10 +88,28 @@ typedef union
   byte_t bytes[sizeof(float)];
 } float_u;
 
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+/* Command bytes from the RX interrupt to BluetoothPoll.  Only the interrupt
+   moves rxHead and only BluetoothPoll moves rxTail. */
+uint8_t rxBuffer[RX_SIZE];
+volatile uint8_t rxHead = 0;
+volatile uint8_t rxTail = 0;
+uint8_t rxOverflows = 0;  /* command bytes dropped because the ring was full */
+
+volatile uint8_t telemetryDue = 0;  /* set by Timer3 when a frame is due    */
+uint8_t telemetrySequence = 0;      /* sequence number of the next frame    */
+uint8_t telemetryDropped = 0;       /* frames skipped for lack of ring room */
 
 /*----------------------------------------------------------------------------*/
 /* Functions                                                                  */
 /*----------------------------------------------------------------------------*/
+static void ProcessCommand(char cmd);
+static void Subscribe(uint8_t rate);
+static void SetBand(uint8_t low, uint8_t high);
+static void SendTelemetry(void);
+
 void InitBluetooth(void)
 {
   /*** Reset Pin Config ***/
@@ -81,16 +137,152 @@ void ResetBluetooth(void)
   __delay_cycles(16000000);
 }
 
+/* Queues the received command byte for BluetoothPoll and nothing else */
 #pragma vector = USART1_RXC_vect
 __interrupt void ISR_USART1_RXC(void)
 {
-  char cmd = ReceiveUART(BLUETOOTH_MODULE);
+  uint8_t data = UDR1;
+  uint8_t next = (rxHead + 1) & (RX_SIZE - 1);
+  
+  if(next == rxTail)
+  {
+    rxOverflows++;
+    return;
+  }
+  rxBuffer[rxHead] = data;
+  rxHead = next;
+  WAKE_MAIN();
+}
+
+/* Telemetry pacing, only runs while the app is subscribed */
+#pragma vector = TIMER3_COMPA_vect
+__interrupt void ISR_COMP3A(void)
+{
+  telemetryDue = 1;
+  WAKE_MAIN();
+}
+
+void BluetoothPoll(void)
+{
+  while(rxTail != rxHead)
+  {
+    char cmd = rxBuffer[rxTail];
+    uint8_t next = (rxTail + 1) & (RX_SIZE - 1);
+    uint8_t args = COMMAND_ARGS(cmd);
+    
+    if(((rxHead - next) & (RX_SIZE - 1)) < args)
+      break;  /* arguments not received yet, try again next time */
+    if(cmd == SUBSCRIBE)
+      Subscribe(rxBuffer[next]);
+    else if(cmd == SET_BAND)
+      SetBand(rxBuffer[next], rxBuffer[(next + 1) & (RX_SIZE - 1)]);
+    else
+      ProcessCommand(cmd);
+    rxTail = (next + args) & (RX_SIZE - 1);
+  }
+  
+  if(telemetryDue)
+  {
+    telemetryDue = 0;
+    SendTelemetry();
+  }
+}
+
+/* Starts the stream at rate frames per second, clamped to 1-20, or stops it
+   when rate is 0.  Timer3 runs in CTC mode with a prescaler of 256. */
+static void Subscribe(uint8_t rate)
+{
+  TCCR3B = 0;
+  ETIMSK &= ~(1<<OCIE3A);
+  telemetryDue = 0;
+  if(rate == 0)
+    return;
+  
+  if(rate > TELEMETRY_MAX_RATE)
+    rate = TELEMETRY_MAX_RATE;
+  TCCR3A = 0;
+  TCNT3 = 0;
+  OCR3A = TELEMETRY_TIMER_HZ / rate - 1;
+  ETIFR = (1<<OCF3A);
+  ETIMSK |= (1<<OCIE3A);
+  TCCR3B = (1<<WGM32)|(1<<CS32);
+  telemetryDue = 1;  /* first frame straight away */
+}
+
+/* Sets the cadence band and tells the app whether it was taken */
+static void SetBand(uint8_t low, uint8_t high)
+{
+  if(SetCadenceBand(low, high) == TRUE)
+    TransmitUART(BLUETOOTH_MODULE, ACK);
+  else
+    TransmitUART(BLUETOOTH_MODULE, NACK);
+}
+
+/* Queues one telemetry frame, multi-byte fields are big-endian:
+   
+     0     sync, 0xA5
+     1     sequence number, +1 per frame
+     2-3   speed, mph in 8.8 fixed point
+     4-5   cadence, rpm in 8.8 fixed point
+     6     front gear
+     7     rear gear
+     8-9   temperature, degrees C
+     10    warning
+     11    power state
+     12    checksum, sum of bytes 1-11
+   
+   A frame that does not fit in the transmit ring is skipped whole, the 
+   app sees the gap in the sequence numbers. */
+static void SendTelemetry(void)
+{
+  uint8_t frame[TELEMETRY_FRAME];
+  SensorSnapshot sensors;
+  int16_t t;
+  uint8_t sum = 0;
+  uint8_t i;
+  
+  if(UartTxFree(BLUETOOTH_MODULE) < TELEMETRY_FRAME)
+  {
+    telemetryDropped++;
+    telemetrySequence++;
+    return;
+  }
+  
+  GetSensorSnapshot(&sensors);
+  t = getTemp();
+  frame[0]  = TELEMETRY_SYNC;
+  frame[1]  = telemetrySequence++;
+  frame[2]  = (uint8_t)(sensors.speed >> 8);
+  frame[3]  = (uint8_t) sensors.speed;
+  frame[4]  = (uint8_t)(sensors.cadence >> 8);
+  frame[5]  = (uint8_t) sensors.cadence;
+  frame[6]  = GetFrontGear();
+  frame[7]  = GetRearGear();
+  frame[8]  = (uint8_t)(t >> 8);
+  frame[9]  = (uint8_t) t;
+  frame[10] = GetWarning();
+  frame[11] = (uint8_t)GetPowerStats();
+  for(i = 1; i < TELEMETRY_FRAME - 1; ++i)
+    sum += frame[i];
+  frame[TELEMETRY_FRAME - 1] = sum;
+  
+  UartWrite(BLUETOOTH_MODULE, frame, TELEMETRY_FRAME);
+}
+
+/* Answers one command from the app */
+static void ProcessCommand(char cmd)
+{
   float_u flt;
   int16_t t;
+  uint16_t latency;
+  task_stats stats;
+  uint8_t i;
+  uint8_t low;
+  uint8_t high;
   switch(cmd)
   {
   case SPEED:
-    flt.flt = GetSpeed();
+    flt.flt = FIX8_8_TO_FLOAT(GetSpeed()); /* app expects a float */
 
     TransmitUART(BLUETOOTH_MODULE, flt.bytes[3]);
     TransmitUART(BLUETOOTH_MODULE, flt.bytes[2]);
@@ -99,7 +291,7 @@ __interrupt void ISR_USART1_RXC(void)
     break;
     
   case CADENCE:
-    flt.flt = GetCadence();
+    flt.flt = FIX8_8_TO_FLOAT(GetCadence());
 
     TransmitUART(BLUETOOTH_MODULE, flt.bytes[3]);
     TransmitUART(BLUETOOTH_MODULE, flt.bytes[2]);
@@ -126,6 +318,47 @@ __interrupt void ISR_USART1_RXC(void)
     TransmitUART(BLUETOOTH_MODULE, (uint8_t)GetPowerStats());
     break;
     
+  case CALIBRATE:
+    RequestCalibration();
+    break;
+    
+  case DUTY_CYCLE:
+    TransmitUART(BLUETOOTH_MODULE, GetAwakePercent());
+    break;
+    
+  case WAKE_TIME:
+    latency = GetWakeLatency();
+    TransmitUART(BLUETOOTH_MODULE, (uint8_t)(latency&0xFF));
+    TransmitUART(BLUETOOTH_MODULE, (uint8_t)(latency>>8));
+    break;
+    
+  case TASK_TIMES:
+    for(i = 0; i < TASK_COUNT; ++i)
+    {
+      GetTaskStats((task_id_t)i, &stats);
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.busy&0xFF));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)((stats.busy>>8)&0xFF));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)((stats.busy>>16)&0xFF));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.busy>>24));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.runs&0xFF));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.runs>>8));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.worst&0xFF));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.worst>>8));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.late&0xFF));
+      TransmitUART(BLUETOOTH_MODULE, (uint8_t)(stats.late>>8));
+    }
+    break;
+    
+  case BAND:
+    GetCadenceBand(&low, &high);
+    TransmitUART(BLUETOOTH_MODULE, low);
+    TransmitUART(BLUETOOTH_MODULE, high);
+    break;
+    
+  case FORGET:
+    LearnReset();
+    break;
+    
   }
 }
 
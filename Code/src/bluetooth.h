@@ -49,6 +49,20 @@ void InitBluetooth(void);
  */
 void ResetBluetooth(void);
 
+/** A Function that answers the commands received from the app since the 
+ *  last call.  The receive interrupt only queues the command bytes, so this
+ *  has to be called from the main loop.  The replies are queued for 
+ *  transmission and sent in the background.
+ *
+ *  Also sends the telemetry frame when one is due.  The app subscribes with
+ *  'S' followed by a rate byte of 1 to 20 frames per second, a rate of 0 
+ *  stops the stream.  The frame layout is documented in bluetooth.c.
+ *  'B' followed by a low and a high cadence in rpm sets the band automatic
+ *  mode shifts for, the reply is 0x06 when the band was taken and 0x15 when
+ *  it was refused.
+ */
+void BluetoothPoll(void);
+
 #endif /* BLUETOOTH_H */
 
 /** @} */ /* bluetooth */
\ No newline at end of file
@@ -8,9 +8,13 @@
  *
  * This source file provides the functions used in main to initialize 
  * button scanning, scan the buttons and output correct button combinations
+ * as gesture events.
  *
- * The following button de-bounce code is a slightly modified version of the
- * one provided by Jack Ganssel here:
+ * The buttons are debounced with a vertical counter: one 2-bit counter 
+ * per button, kept across two bytes, counts the samples that disagree with
+ * the debounced state.  Four disagreeing samples in a row, 8ms at the 2ms
+ * poll, flip the button.  All four buttons are counted at once in a few
+ * instructions, see Jack Ganssle on debouncing:
  * http://www.ganssle.com/debouncing-pt2.htm
  * 
  *
@@ -21,29 +25,45 @@
 /*----------------------------------------------------------------------------*/
  
 #include "common.h"
-
-/* The following button debounce code is a slightly modified version of the
-   one provided by Jack Ganssel here:
-   http://www.ganssle.com/debouncing-pt2.htm 
-*/
+#include "button.h"
+#include "timebase.h"
+#include "scheduler.h"
+#include "led.h"
 
 /*----------------------------------------------------------------------------*/
 /* Defines                                                                    */
 /*----------------------------------------------------------------------------*/
-#define MAX_CHECKS 8
+#define POLL_MS    TICK_MS  /* Timer0 period, see InitButtons              */
+#define GESTURE_TICKS 5 /* gestures run every 10ms                           */
+#define GESTURE_MS (GESTURE_TICKS * POLL_MS)
+#define HOLD_STEPS   (BUTTON_HOLD_MS / GESTURE_MS)
+#define DOUBLE_STEPS (BUTTON_DOUBLE_MS / GESTURE_MS)
+#define EVENT_SIZE 8    /* event queue size, power of 2                      */
 
 /*----------------------------------------------------------------------------*/
 /* Global Data                                                                */
 /*----------------------------------------------------------------------------*/
-uint8_t buttonStates[MAX_CHECKS] = {0x0F,
-                                    0x0F,
-                                    0x0F,
-                                    0x0F,
-                                    0x0F,
-                                    0x0F,
-                                    0x0F,
-                                    0x0F}; /* circular queue */
-uint8_t index = 0;
+/* debounce, 1 meaning pressed */
+uint8_t debounced = 0;        /* debounced buttons                          */
+uint8_t count0 = 0xFF;        /* low bits of the vertical counters          */
+uint8_t count1 = 0xFF;        /* high bits of the vertical counters         */
+uint8_t pressEdges = 0;       /* buttons pressed since the last gesture step*/
+uint8_t gestureTicks = 0;
+
+/* gesture recognition, in GESTURE_MS steps */
+uint8_t  chord = 0;           /* buttons pressed since all were released   */
+uint8_t  lastTap = 0;         /* chord of the last press, 0 after a double */
+uint8_t  sinceTap = 0xFF;     /* steps since lastTap was released          */
+uint8_t  downSteps = 0;       /* steps the current chord has been down     */
+bool_t   held = FALSE;        /* the current chord was sent as a hold      */
+bool_t   secondTap = FALSE;   /* the current chord may be a double         */
+
+/* Events from the polling interrupt to GetButtonEvent.  Only the interrupt
+   moves eventHead and only GetButtonEvent moves eventTail. */
+button_event events[EVENT_SIZE];
+volatile uint8_t eventHead = 0;
+volatile uint8_t eventTail = 0;
+uint8_t eventsDropped = 0;
 
 /*----------------------------------------------------------------------------*/
 /* Functions                                                                  */
@@ -52,39 +72,121 @@ uint8_t index = 0;
 void InitButtons()
 {
   TCCR0 |= (1<<WGM01)  /* CTC mode */
-         | (1<<CS01);  /* prescalar of 8 */
+         | (1<<CS02)   /* prescalar of 128 */
+         | (1<<CS00);
   
   TIMSK |= (1<<OCIE0); /* Enable interupt on compare match */
   
-  OCR0 = 200;          /* count up to 100us */
+  OCR0 = 249;          /* count up to 2ms */
   DDRB = ~0x0F;
   PORTB = 0x0F;
   __enable_interrupt();
 }
 
-/** Interrupt servic routine that scans PINB every 100us and stores the data 
- *  into an array selected by an incrementing index value.  Index counts up 
- *  to 7 and then loops to overwrite the previous values.
+/* Queues one event, called from the polling interrupt */
+static void ButtonEmit(button_event_t type, uint8_t buttons)
+{
+  uint8_t next = (eventHead + 1) & (EVENT_SIZE - 1);
+  
+  if(next == eventTail)
+  {
+    eventsDropped++;
+    return;
+  }
+  events[eventHead].type = type;
+  events[eventHead].buttons = BUTTONS_RELEASED & ~buttons;
+  events[eventHead].stamp = NowMs();
+  eventHead = next;
+}
+
+/* Runs every GESTURE_MS on the debounced state.  The chord collects every
+   button pressed until all are released again, then the release, or the
+   hold time running out, decides which event it was. */
+static void ButtonGesture(uint8_t pressed)
+{
+  
+  if(pressed != 0)
+  {
+    if(chord == 0)
+    {
+      downSteps = 0;
+      held = FALSE;
+      secondTap = (sinceTap < DOUBLE_STEPS) ? TRUE : FALSE;
+    }
+    chord |= pressed;
+    if(held == FALSE && ++downSteps >= HOLD_STEPS)
+    {
+      held = TRUE;
+      lastTap = 0;
+      ButtonEmit(BUTTON_HOLD, chord);
+    }
+  }
+  else if(chord != 0)
+  {
+    if(held == FALSE)
+    {
+      if(secondTap == TRUE && chord == lastTap)
+      {
+        ButtonEmit(BUTTON_DOUBLE, chord);
+        lastTap = 0;
+      }
+      else
+      {
+        ButtonEmit(BUTTON_PRESS, chord);
+        lastTap = chord;
+      }
+      sinceTap = 0;
+    }
+    chord = 0;
+  }
+  else if(sinceTap != 0xFF)
+    sinceTap++;
+}
+
+/** Interrupt servic routine that samples PINB every 2ms and runs the 
+ *  vertical counters.  A counter is held at 3 while its button agrees with
+ *  the debounced state and counts down on every sample that disagrees, the
+ *  button flips when it wraps.  Presses are kept as edge flags for the 
+ *  gesture recognition, which runs every 10ms.  It is also the system 
+ *  tick of the scheduler and the LED patterns.
  *
- *  @param [Out] buttonStates[] The array to hold the values of buttons polled
+ *  @param [Out] debounced = the debounced buttons, 1 meaning pressed.
  *			
  */
 #pragma vector= TIMER0_COMP_vect
 __interrupt void ButtonPollingISR(void)
 {
-  buttonStates[index] = PINB & 0x0F;
-  index = (index + 1) & 0x07; /* increment index and mask to circle queue */
+  uint8_t changed = debounced ^ (~PINB & BUTTONS_RELEASED);
+  
+  count0 = ~(count0 & changed);
+  count1 = count0 ^ (count1 & changed);
+  changed &= count0 & count1;
+  debounced ^= changed;
+  pressEdges |= debounced & changed;
+  SchedulerTick();
+  LedTick();
+  
+  if(++gestureTicks == GESTURE_TICKS)
+  {
+    gestureTicks = 0;
+    /* a press shorter than a gesture step still counts */
+    ButtonGesture(debounced | pressEdges);
+    pressEdges = 0;
+  }
 }
 
 uint8_t GetButtonState()
 {
-  uint8_t i;
-  uint8_t debounced = 0x0F;
-  
-  for(i = 0; i < MAX_CHECKS; ++i) 
-    debounced = debounced & buttonStates[i]; /*and all array values with 0x0F to
-											   hold all 0s then return*/
-  return debounced;
+  return BUTTONS_RELEASED & ~debounced;
+}
+
+bool_t GetButtonEvent(button_event* event)
+{
+  if(eventTail == eventHead)
+    return FALSE;
+  *event = events[eventTail];
+  eventTail = (eventTail + 1) & (EVENT_SIZE - 1);
+  return TRUE;
 }
 
 /** @} */ /* button */
\ No newline at end of file
@@ -15,7 +15,11 @@
  * PORTB 0 (Left handle bar top button), 1 (Left handle bar bottom button),
  * 2 (Right handle bar top button), 3 (Right handle bar bottom button).
  *
- *
+ * The polling interrupt turns the debounced buttons into timestamped 
+ * events: a press once a chord is released, a hold once it has been down
+ * for BUTTON_HOLD_MS and a double when the same chord is tapped again 
+ * within BUTTON_DOUBLE_MS.  The main loop reads them with GetButtonEvent
+ * and never waits on the buttons.
  *
  *
  *
@@ -27,6 +31,11 @@
 #ifndef BUTTON_H
 #define BUTTON_H
 
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
 /*----------------------------------------------------------------------------*/
 /* Defines                                                                    */
 /*----------------------------------------------------------------------------*/
@@ -40,29 +49,55 @@
 #define HILL_NEARBY      0x0A
 #define BUTTONS_RELEASED 0x0F
 
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+/** BUTTON_PRESS is sent when a chord is released before it became a hold,
+ *  BUTTON_HOLD once while it is still down and nothing on its release.  A
+ *  second tap of the same chord sends BUTTON_DOUBLE instead of a press, 
+ *  the first tap has already been sent as a press by then.
+ */
+typedef enum {BUTTON_PRESS = 0, BUTTON_HOLD, BUTTON_DOUBLE} button_event_t;
+
+/** One gesture, buttons uses the codes above, e.g. SWITCH_MODE */
+typedef struct
+{
+  button_event_t type;
+  uint8_t  buttons;   /* every button in the chord, 0 meaning pressed */
+  uint32_t stamp;     /* NowMs() when it was recognized               */
+} button_event;
 
 /*----------------------------------------------------------------------------*/
 /* Function Prototypes                                                        */
 /*----------------------------------------------------------------------------*/
 
-/** Initializes timer/counter0 to count up to 100us in CTC mode and trigger an 
- *  interrupt when the count reaches the top value set to 200 with a 
- *  prescaler of 8.
+/** Initializes timer/counter0 to count up to 2ms in CTC mode and trigger an 
+ *  interrupt when the count reaches the top value set to 249 with a 
+ *  prescaler of 128.
  */
 void InitButtons();
 
-/** Takes all values in the current buttonStates array and uses a logic AND 
- *  with the value 0x0F (debounced) to store all 0s located at any part in 
- *  the array. Returns value of debounced with 0s meaning a button was 
- *  pressed.  Four bit values are associated with different inputs and are 
- *  shown above in the Defines section.
+/** Returns the debounced buttons with 0s meaning a button is pressed.
+ *  Four bit values are associated with different inputs and are shown 
+ *  above in the Defines section.  A button only changes after four 
+ *  samples in a row, 8ms, agree.
  *
  * @returns
- *		- returns debounced, the ANDed value of all values in the buttonStates
- * 		  array.
+ *		- returns the debounced buttons kept by the polling interrupt.
  *
  */  
 uint8_t GetButtonState();
 
+/** Takes the oldest button event out of the queue, never waits.  Events 
+ *  that find the queue full are dropped.
+ *
+ * @par Parameters
+ *		- @a event = filled in with the event.
+ *
+ * @returns
+ *		- returns TRUE when there was an event.
+ */
+bool_t GetButtonEvent(button_event* event);
+
 #endif /* BUTTON_H */
 /** @} */ /* button */
\ No newline at end of file
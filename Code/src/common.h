@@ -34,8 +34,18 @@ typedef signed char        int8_t    /** portable 8-bit signed integer */    ;
 typedef unsigned int     uint16_t    /** portable 16-bit unsigned integer */ ;
 typedef signed int        int16_t    /** portable 16-bit signed integer */   ;
 typedef unsigned long    uint32_t    /** portable 32-bit unsigned number */  ;
-typedef unsigned long     int32_t    /** portable 32-bit signed number */    ;
+typedef signed long       int32_t    /** portable 32-bit signed number */    ;
 typedef enum {TRUE, FALSE} bool_t    /** portable  boolean indicator */      ;
+typedef unsigned int    ufix8_8_t    /** unsigned Q8.8 fixed point number */ ;
+typedef signed int       fix8_8_t    /** signed Q8.8 fixed point number */   ;
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define FIX8_8(x)          ((ufix8_8_t)((x)*256.0 + 0.5)) /* constant to Q8.8  */
+#define FIX8_8_TO_FLOAT(x) ((x)/256.0f)                   /* Q8.8 to float     */
+#define FIX8_8_INT(x)      ((x) >> 8)                     /* Q8.8 integer part */
+#define SFIX8_8(x)         ((fix8_8_t)((x)*256.0))        /* constant to signed Q8.8 */
 
 #endif /* COMMON_H */
 /** @} */ /* common */
\ No newline at end of file
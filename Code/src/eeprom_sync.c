@@ -0,0 +1,38 @@
+/**
+ * @file   eeprom_sync.c  <br>
+ * @brief  EEprom write source file  <br>
+ * @defgroup eeprom_sync EEprom Sync
+ * @{
+ *
+ * This source file compares a copy in EEprom with RAM and writes the first
+ * byte that changed.  An __eeprom store waits on EEWE before it starts, so
+ * checking EEWE first is what keeps the caller from ever waiting.
+ *
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "eeprom_sync.h"
+
+/*----------------------------------------------------------------------------*/
+/* FUNCTIONS                                                                  */
+/*----------------------------------------------------------------------------*/
+bool_t EEpromSync(uint8_t __eeprom* ee, uint8_t const* ram, uint8_t size)
+{
+  uint8_t i;
+
+  if(EECR & (1<<EEWE))
+    return FALSE;  /* EEprom can not be read while it writes either */
+  for(i = 0; i < size; ++i)
+  {
+    if(ee[i] != ram[i])
+    {
+      ee[i] = ram[i];
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/** @} */ /* eeprom_sync */
@@ -0,0 +1,43 @@
+/**
+ * @file   eeprom_sync.h  <br>
+ * @brief  Header file for the EEprom writes. <br>
+ * @defgroup eeprom_sync EEprom Sync
+ * @{
+ *
+ * This header file contains the function prototype used to copy settings
+ * into EEprom without waiting for it.  An EEprom write takes 8.5ms and the
+ * CPU can not read EEprom meanwhile, so a copy is written one byte per call
+ * and only once the last byte is done.  Callers keep calling it, e.g. once
+ * per task run, until it reports the copy done.  Since every caller checks
+ * for a write in progress, any number of copies can run at the same time.
+ *
+ */
+
+/* Used to prevent multiple inclusion of the header file */
+#ifndef EEPROM_SYNC_H
+#define EEPROM_SYNC_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Writes the first byte of ram that differs from EEprom, in address order,
+ *  when EEprom is not busy with another write.
+ *
+ *  @par Parameters
+ *				-@a ee = EEprom copy.
+ *				-@a ram = data to store.
+ *				-@a size = bytes to compare.
+ *
+ *	@returns
+ *			-Returns TRUE once EEprom holds all of ram, FALSE while there is
+ *			 a write left or EEprom is busy.
+ */
+bool_t EEpromSync(uint8_t __eeprom* ee, uint8_t const* ram, uint8_t size);
+
+#endif /* EEPROM_SYNC_H */
+/** @} */ /* eeprom_sync */
@@ -0,0 +1,162 @@
+/**
+ * @file   gearing.c  <br>
+ * @brief  Gear ratio source file  <br>
+ * @defgroup gearing Gearing
+ * @{
+ *
+ * This source file works out the cadence of every gear from the speed.  The
+ * wheel rpm is divided by each chainring once and multiplied by each cog,
+ * so picking a gear takes three divisions.
+ *
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "gearing.h"
+#include "eeprom_sync.h"
+#include "learn.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+/* wheel rpm per mph, Q8 */
+#define WHEEL_RPM_FACTOR  ((uint32_t)(256/WHEEL_MPH_PER_RPM + 0.5))
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+static __flash const uint8_t ringTeeth[FRONT_GEARS] = CHAINRING_TEETH;
+static __flash const uint8_t cogTeeth[REAR_GEARS] = COG_TEETH;
+static __flash const uint8_t usableRears[FRONT_GEARS] = GEAR_USABLE;
+
+__eeprom static uint8_t bandLowEE;
+__eeprom static uint8_t bandHighEE;
+
+uint8_t bandLow = CADENCE_LOW;
+uint8_t bandHigh = CADENCE_HIGH;
+
+/*----------------------------------------------------------------------------*/
+/* FUNCTIONS                                                                  */
+/*----------------------------------------------------------------------------*/
+static bool_t BandValid(uint8_t low, uint8_t high)
+{
+  if(low < CADENCE_MIN || high > CADENCE_MAX || high < low + CADENCE_MIN_BAND)
+    return FALSE;
+  return TRUE;
+}
+
+void InitGearing(void)
+{
+  uint8_t low = bandLowEE;
+  uint8_t high = bandHighEE;
+
+  if(BandValid(low, high) == TRUE)  /* erased EEprom reads 0xFF */
+  {
+    bandLow = low;
+    bandHigh = high;
+  }
+}
+
+/* Wheel rpm at a speed, Q8.8 */
+static uint32_t WheelRpm(ufix8_8_t speed)
+{
+  return ((uint32_t)speed * WHEEL_RPM_FACTOR) >> 8;
+}
+
+ufix8_8_t GearCadence(ufix8_8_t speed, uint8_t gear)
+{
+  uint32_t cadence = WheelRpm(speed) / ringTeeth[GEAR_FRONT(gear) - 1]
+                     * cogTeeth[GEAR_REAR(gear) - 1];
+
+  return (cadence > 0xFFFF) ? 0xFFFF : (ufix8_8_t)cadence;
+}
+
+/* Compares the ratios ring/cog cross multiplied, so no division is needed */
+bool_t GearHarder(uint8_t gear, uint8_t than)
+{
+  uint16_t ratio = (uint16_t)ringTeeth[GEAR_FRONT(gear) - 1]
+                   * cogTeeth[GEAR_REAR(than) - 1];
+  uint16_t thanRatio = (uint16_t)ringTeeth[GEAR_FRONT(than) - 1]
+                       * cogTeeth[GEAR_REAR(gear) - 1];
+
+  return (ratio > thanRatio) ? TRUE : FALSE;
+}
+
+uint8_t TargetGear(ufix8_8_t speed, uint8_t gear, uint8_t cap)
+{
+  uint32_t wheel = WheelRpm(speed);
+  uint8_t middle = LearnedCadence(speed);
+  uint8_t half = (bandHigh - bandLow) / 2 + CADENCE_HYSTERESIS;
+  uint32_t target;
+  uint32_t perCog;
+  uint32_t cadence;
+  uint32_t error;
+  uint32_t bestError = 0xFFFFFFFF;
+  uint8_t best = gear;
+  uint8_t front;
+  uint8_t rear;
+
+  /* the band is moved to the cadence the rider picked at this speed */
+  if(middle == 0)
+    middle = (bandLow + bandHigh) / 2;
+  target = (uint32_t)middle << 8;
+
+  cadence = GearCadence(speed, gear);
+  error = (cadence > target) ? cadence - target : target - cadence;
+  if(error <= ((uint32_t)half << 8)
+     && (cap == NO_GEAR || GearHarder(gear, cap) == FALSE))
+    return gear;
+
+  for(front = 1; front <= FRONT_GEARS; ++front)
+  {
+    perCog = wheel / ringTeeth[front - 1];
+    for(rear = 1; rear <= REAR_GEARS; ++rear)
+    {
+      if((usableRears[front - 1] & (1 << (rear - 1))) == 0)
+        continue;
+      if(cap != NO_GEAR && GearHarder(GEAR(front, rear), cap) == TRUE)
+        continue;
+
+      cadence = perCog * cogTeeth[rear - 1];
+      error = (cadence > target) ? cadence - target : target - cadence;
+      if(front != GEAR_FRONT(gear))
+        error += (uint32_t)CADENCE_HYSTERESIS << 8;  /* front shifts are slow */
+      if(error < bestError)
+      {
+        bestError = error;
+        best = GEAR(front, rear);
+      }
+    }
+  }
+
+  /* a cap that no usable gear fits under is shifted to as it is */
+  if(bestError == 0xFFFFFFFF)
+    return cap;
+  return best;
+}
+
+bool_t SetCadenceBand(uint8_t low, uint8_t high)
+{
+  if(BandValid(low, high) == FALSE)
+    return FALSE;
+
+  bandLow = low;
+  bandHigh = high;
+  return TRUE;
+}
+
+bool_t GearingFlush(void)
+{
+  if(EEpromSync(&bandLowEE, &bandLow, 1) == FALSE)
+    return FALSE;
+  return EEpromSync(&bandHighEE, &bandHigh, 1);
+}
+
+void GetCadenceBand(uint8_t* low, uint8_t* high)
+{
+  *low = bandLow;
+  *high = bandHigh;
+}
+
+/** @} */ /* gearing */
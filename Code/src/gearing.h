@@ -0,0 +1,116 @@
+/**
+ * @file   gearing.h  <br>
+ * @brief  Header file for the gear ratios. <br>
+ * @defgroup gearing Gearing
+ * @{
+ *
+ * This header file contains the function prototypes used by automatic mode
+ * to pick a gear from the tooth counts of the 3x7 drivetrain.  The wheel
+ * speed and the ratio of a gear give the cadence the rider would pedal in
+ * it, so the gear that puts the cadence closest to the rider's target band
+ * can be found straight away, however far it is from the current one.
+ *
+ * A gear is one number, (front-1)*7 + (rear-1), the same as the states of
+ * the shift paths.  The cadence band is kept in EEprom, the app sets it.
+ * A new band is written to EEprom in the background by GearingFlush().
+ *
+ */
+
+/* Used to prevent multiple inclusion of the header file */
+#ifndef GEARING_H
+#define GEARING_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define FRONT_GEARS   3
+#define REAR_GEARS    7
+#define GEAR_COUNT    (FRONT_GEARS * REAR_GEARS)
+#define NO_GEAR       0xFF
+
+#define GEAR(front, rear)  ((uint8_t)(((front) - 1) * REAR_GEARS + ((rear) - 1)))
+#define GEAR_FRONT(gear)   ((gear) / REAR_GEARS + 1)
+#define GEAR_REAR(gear)    ((gear) % REAR_GEARS + 1)
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Loads the cadence band from EEprom, the defaults of user_config.h are
+ *  used until the app sets one.
+ */
+void InitGearing(void);
+
+/** Returns the cadence the rider pedals at in a gear.
+ *
+ *  @par Parameters
+ *				-@a speed = speed in mph, Q8.8 fixed point.
+ *				-@a gear = gear to look at.
+ *
+ *  @returns
+ *			- returns the cadence in rpm, Q8.8 fixed point
+ */
+ufix8_8_t GearCadence(ufix8_8_t speed, uint8_t gear);
+
+/** A function used to compare two gears by ratio.
+ *
+ *  @par Parameters
+ *				-@a gear = gear to check.
+ *				-@a than = gear to compare it with.
+ *
+ *  @returns
+ *			-Returns TRUE when gear is harder to pedal than than.
+ */
+bool_t GearHarder(uint8_t gear, uint8_t than);
+
+/** Picks the gear for a speed.  The band is centered on the cadence learned
+ *  for the speed, when there is one.  The current gear is kept while its 
+ *  cadence is inside the band widened by CADENCE_HYSTERESIS, otherwise the
+ *  gear with the cadence closest to the middle of the band is returned.  Cross
+ *  chained gears are never picked, and a gear on the current chainring is
+ *  preferred, since a front shift takes longer.
+ *
+ *  @par Parameters
+ *				-@a speed = speed in mph, Q8.8 fixed point.
+ *				-@a gear = current gear.
+ *				-@a cap = hardest gear allowed, NO_GEAR for none.
+ *
+ *  @returns
+ *			- returns the gear to shift to, gear when no shift is needed
+ */
+uint8_t TargetGear(ufix8_8_t speed, uint8_t gear, uint8_t cap);
+
+/** Sets the cadence band, GearingFlush() stores it in EEprom.
+ *
+ *  @par Parameters
+ *				-@a low = lowest cadence in the band, rpm.
+ *				-@a high = highest cadence in the band, rpm.
+ *
+ *  @returns
+ *			-Returns FALSE, keeping the old band, when the band is outside
+ *			 CADENCE_MIN to CADENCE_MAX or narrower than CADENCE_MIN_BAND.
+ */
+bool_t SetCadenceBand(uint8_t low, uint8_t high);
+
+/** Writes the next byte of the cadence band that EEprom does not hold yet,
+ *  without waiting for EEprom.  Called until it returns TRUE.
+ *
+ *	@returns
+ *			-Returns TRUE once EEprom holds the band in use.
+ */
+bool_t GearingFlush(void);
+
+/** Returns the cadence band in use.
+ *
+ *  @par Parameters
+ *				-@a low = filled in with the lowest cadence, rpm.
+ *				-@a high = filled in with the highest cadence, rpm.
+ */
+void GetCadenceBand(uint8_t* low, uint8_t* high);
+
+#endif /* GEARING_H */
+/** @} */ /* gearing */
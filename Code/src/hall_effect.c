@@ -18,6 +18,45 @@
 /*----------------------------------------------------------------------------*/
 #include "hall_effect.h"
 #include "common.h"
+#include "power.h"
+#include "timebase.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define HALL_WINDOW_US     1000000UL /* the 1 second Timer1 window, in us     */
+#define HALL_HISTORY       8       /* edge timestamps kept, power of 2        */
+#define HALL_MIN_PERIOD    5000    /* edges closer than 5ms are glitches      */
+#define HALL_STOP_WINDOWS  2       /* idle windows before reporting a stop    */
+
+/* Q8.8 mph per (tire tick / us), (1/4 rotation * 60s * MPH conversion) * 10^6 */
+#define TIRE_SPEED_FACTOR  ((uint32_t)(15*WHEEL_MPH_PER_RPM*HALL_WINDOW_US*256 + 0.5))
+/* Q8.8 rpm per (pedal tick / us), (.2 rotation * 60s) * 10^6 */
+#define PEDAL_RPM_FACTOR   (12*HALL_WINDOW_US*256)
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t stamp[HALL_HISTORY]; /* circular queue of edge timestamps     */
+  uint8_t  head;                /* index of the newest timestamp         */
+  uint8_t  edges;               /* valid timestamps in the queue         */
+  uint8_t  idle;                /* Timer1 windows since the last edge    */
+} hall_sensor;
+
+/* Raw measurements written by the interrupts.  Each sensor reports a number
+   of periods and the time they took, which covers both modes, and
+   the divisions are left to GetSensorSnapshot outside of interrupt context.*/
+typedef struct
+{
+  uint32_t tireSpan;     /* us spanned by tirePeriods                   */
+  uint32_t pedalSpan;    /* us spanned by pedalPeriods                  */
+  uint8_t  tirePeriods;  /* tire periods measured, 0 when stopped       */
+  uint8_t  pedalPeriods; /* pedal periods measured, 0 when stopped      */
+  bool_t   shiftFlag;    /* TRUE when new data is waiting for auto shift */
+  uint8_t  sequence;     /* incremented by every interrupt that writes  */
+} hall_raw;
 
 /*----------------------------------------------------------------------------*/
 /* Global Data                                                                */
@@ -27,28 +66,19 @@ float TireHallCount = 0;
 float PedalHallCount = 0;
 float PedalRPM;
 float TireRPM;
-float cadence;
-float speed;
-uint8_t tireTicks;
 uint8_t pedalTicks;
 int countPedal =0;
 int countTire = 0;
-bool_t shiftFlag = FALSE;
-
+volatile hall_raw sensors = {0, 0, 0, 0, FALSE, 0}; /* only written by ISRs */
+hall_sensor tire;
+hall_sensor pedal;
+volatile uint16_t tireIdleSeconds = 0; /* windows without any tire edge */
 
 /*----------------------------------------------------------------------------*/
 /* FUNCTIONS                                                                  */
 /*----------------------------------------------------------------------------*/
 void InitHallEffect()
 {
-    TCCR1B |= ((1<<CS12) | (1<<WGM12)); // CTC mode and 256 pre-scaler
-    
-    TIFR |= 1<<OCF1A; // Timer/Counter1, Output Compare A Match Flag
-    
-    TIMSK |= 1 << OCIE1A;  // Timer/Counter1, Output Compare A Match Interrupt Enable
-    
-    OCR1A = 62500; // Set time for 1 second 
-    
     EIMSK |= (1<<INT6); // Turn on INT6 (Tire)
     
     EICRB |= ((1<<ISC61) | (0<<ISC60));  // Set to activate on falling edge
@@ -60,48 +90,186 @@ void InitHallEffect()
     __enable_interrupt();
 }
 
-/* interrupt activated when the Timer/Counter 1 value reaches 62500 or 1 second. 
-   Calculates our speed and cadence using this 1 second interval, then resets the
-   values to 0 until the next calculation*/
-#pragma vector= TIMER1_COMPA_vect
-__interrupt void ISR_COMP1A()
+/* Stores a new edge for sensor and returns the time spanned by the last 
+   magnets edges (one full rotation) or fewer if the sensor just started 
+   moving.  The number of periods measured is returned through periods, 
+   which is 0 when the edge was rejected or is the first one seen.*/
+static uint32_t HallEdge(hall_sensor* sensor, uint8_t magnets, uint8_t* periods)
 {
-  speed = countTire*15*0.081439248;  // (.25(ticks/rotation) * 60s* (MPH conversion)
-  tireTicks = countTire;
-  cadence = countPedal*12;  // .2 * 60s (5 ticks per rotation)
+  uint32_t now = NowUs();
+  uint8_t n;
+  
+  *periods = 0;
+  if(sensor->edges != 0 && (now - sensor->stamp[sensor->head]) < HALL_MIN_PERIOD)
+    return 0;
+  
+  sensor->head = (sensor->head + 1) & (HALL_HISTORY - 1);
+  sensor->stamp[sensor->head] = now;
+  sensor->idle = 0;
+  if(sensor->edges <= magnets)
+    sensor->edges++;
+  
+  n = sensor->edges - 1;
+  *periods = n;
+  return now - sensor->stamp[(sensor->head - n) & (HALL_HISTORY - 1)];
+}
+
+/* Called from the Timer1 compare match interrupt every 1 second. In window
+   mode it calculates our speed and cadence using this 1 second interval, 
+   then resets the values to 0 until the next calculation.  In period mode it
+   zeroes a sensor that has not seen an edge for HALL_STOP_WINDOWS seconds.*/
+void HallWindow()
+{
+  WAKE_MAIN();
+  if(tireIdleSeconds != 0xFFFF)
+    tireIdleSeconds++;
+#if HALL_MEASURE_MODE == HALL_MODE_PERIOD
+  if(tire.edges != 0 && ++tire.idle >= HALL_STOP_WINDOWS)
+  {
+    tire.edges = 0;
+    sensors.tirePeriods = 0;
+    sensors.shiftFlag = TRUE;
+    sensors.sequence++;
+  }
+  if(pedal.edges != 0 && ++pedal.idle >= HALL_STOP_WINDOWS)
+  {
+    pedal.edges = 0;
+    sensors.pedalPeriods = 0;
+    sensors.sequence++;
+  }
+#else
+  sensors.tirePeriods = (countTire > 255) ? 255 : countTire;
+  sensors.tireSpan = HALL_WINDOW_US;
+  sensors.pedalPeriods = (countPedal > 255) ? 255 : countPedal;
+  sensors.pedalSpan = HALL_WINDOW_US;
+  sensors.shiftFlag = TRUE;  //Set new data ready flag
+  sensors.sequence++;
   countPedal = 0;
   countTire = 0;
-  shiftFlag = TRUE;  //Set new data ready flag
+#endif
 }
 
 /* interrupt located on PINE6 and is connected to the signal pin of our tire 
-   Hall Effect sensor, it uses INT_6 vector to count negative edges.*/
+   Hall Effect sensor, it uses INT_6 vector to count negative edges.  In period
+   mode the last rotation is handed to the readers on every edge.*/
 #pragma vector= INT6_vect
 __interrupt void ISR_INT6()
 {
+  tireIdleSeconds = 0;
+#if HALL_MEASURE_MODE == HALL_MODE_PERIOD
+  uint8_t n;
+  uint32_t span = HallEdge(&tire, TIRE_MAGNETS, &n);
+  
+  if(n != 0)
+  {
+    sensors.tirePeriods = n;
+    sensors.tireSpan = span;
+    sensors.shiftFlag = TRUE;  //Set new data ready flag
+    sensors.sequence++;
+    WAKE_MAIN();
+  }
+#else
   countTire++;
+#endif
 }
 
 /* interrupt located on PINE5 and is connected to the signal pin of our pedal 
-   Hall Effect sensor, it uses INT_5 vector to count negative edges.*/
+   Hall Effect sensor, it uses INT_5 vector to count negative edges.  In period
+   mode the last rotation is handed to the readers on every edge.*/
 #pragma vector= INT5_vect
 __interrupt void ISR_INT5()
 {
+#if HALL_MEASURE_MODE == HALL_MODE_PERIOD
+  uint8_t n;
+  uint32_t span = HallEdge(&pedal, PEDAL_MAGNETS, &n);
+  
+  if(n != 0)
+  {
+    sensors.pedalPeriods = n;
+    sensors.pedalSpan = span;
+    sensors.sequence++;
+    WAKE_MAIN();
+  }
+#else
   countPedal++;
+#endif
+}
+
+/* Converts periods over span us into a rate using factor, saturating 
+   instead of overflowing.  periods * factor does not fit in 32 bits, so 
+   factor is divided first and the remainder is added back.*/
+static uint16_t HallRate(uint8_t periods, uint32_t span, uint32_t factor)
+{
+  uint32_t whole;
+  uint32_t rate;
+  
+  if(periods == 0 || span == 0)
+    return 0;
+  whole = factor / span;
+  if(whole > 0xFFFF)
+    return 0xFFFF;
+  rate = periods*whole + (periods*(factor % span))/span;
+  return (rate > 0xFFFF) ? 0xFFFF : (uint16_t)rate;
+}
+
+void GetSensorSnapshot(SensorSnapshot* snapshot)
+{
+  hall_raw raw;
+  uint8_t sequence;
+  uint16_t ticks;
+  
+  /* interrupts don't nest, so a writer always finishes before we look at
+     sequence again and an unchanged sequence means an untorn copy.  The
+     sequence has to be read before the copy, the copy itself reads it 
+     last and would already see the new one. */
+  do
+  {
+    sequence = sensors.sequence;
+    raw = sensors;
+  } while(sequence != sensors.sequence);
+  
+  snapshot->speed = HallRate(raw.tirePeriods, raw.tireSpan, TIRE_SPEED_FACTOR);
+  snapshot->cadence = HallRate(raw.pedalPeriods, raw.pedalSpan, PEDAL_RPM_FACTOR);
+  ticks = HallRate(raw.tirePeriods, raw.tireSpan, HALL_WINDOW_US);
+  snapshot->tireTicks = (ticks > 255) ? 255 : (uint8_t)ticks;
+  snapshot->shiftFlag = raw.shiftFlag;
+  snapshot->sequence = raw.sequence;
+}
+
+__monitor void ClearShiftFlag(uint8_t sequence)
+{
+  if(sensors.sequence == sequence)
+    sensors.shiftFlag = FALSE;
+}
+
+__monitor uint16_t GetTireIdleSeconds()
+{
+  return tireIdleSeconds;
+}
+
+__monitor void ClearTireIdle()
+{
+  tireIdleSeconds = 0;
 }
 
-float GetSpeed()
+ufix8_8_t GetSpeed()
 {
-  return speed;
+  SensorSnapshot snapshot;
+  GetSensorSnapshot(&snapshot);
+  return snapshot.speed;
 }
 
 uint8_t GetTireTicks()
 {
-  return tireTicks;
+  SensorSnapshot snapshot;
+  GetSensorSnapshot(&snapshot);
+  return snapshot.tireTicks;
 }
 
-float GetCadence()
+ufix8_8_t GetCadence()
 {
-  return cadence;
+  SensorSnapshot snapshot;
+  GetSensorSnapshot(&snapshot);
+  return snapshot.cadence;
 }
 /** @} */ /* hall_effect */
\ No newline at end of file
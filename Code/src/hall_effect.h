@@ -16,6 +16,11 @@
  * on the pedals and on the spokes of the rear tires.  The signal pins of
  * the sensor are connected to PORTE 5 (Pedal) and 6 (Tire).
  *
+ * Two measurement modes are selected by HALL_MEASURE_MODE in user_config.h.
+ * Window mode counts edges over the 1 second Timer1 window of the timebase.
+ * Period mode stamps every edge with NowUs() (16us resolution) and 
+ * recalculates speed and cadence from the time taken by the last full 
+ * rotation on every edge.
  *
  * 
  *
@@ -35,40 +40,94 @@
 /*----------------------------------------------------------------------------*/
 #include "common.h"
 
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+/** Copy of all sensor values written by the hall effect interrupts.  The
+ *  interrupts bump sequence after every update, so a reader knows the copy
+ *  it made is consistent when sequence did not change while copying.  Speed 
+ *  and cadence are unsigned Q8.8 fixed point (value * 256).
+ */
+typedef struct
+{
+  ufix8_8_t speed;    /* mph, Q8.8                                     */
+  ufix8_8_t cadence;  /* rpm, Q8.8                                     */
+  uint8_t tireTicks;  /* tire ticks per second                         */
+  bool_t  shiftFlag;  /* TRUE when new data is waiting for auto shift  */
+  uint8_t sequence;   /* incremented by every interrupt that writes    */
+} SensorSnapshot;
+
 /*----------------------------------------------------------------------------*/
 /* Function Prototypes                                                        */
 /*----------------------------------------------------------------------------*/
-/** Sets all the proper bits to activate timer/counter 1 into 
- *		-CTC mode with a 256 prescaler.
- *      -Top set to 62500 and will trigger an interrupt every 1 second.
- *  Sets two external interrupts (5&6) on PORTE 5&6 to 
+/** Sets two external interrupts (5&6) on PORTE 5&6 to 
  *  	-trigger on a falling edge.
+ *  The 1 second window comes from the timebase, InitTimebase() has to be
+ *  called as well.
  */
 void  InitHallEffect();
 
+/** Ends the 1 second measurement window, called from the Timer1 compare 
+ *  match interrupt of the timebase.
+ */
+void HallWindow();
+
 /** Returns the current speed value at the time the function is called
  *
  *  @returns
- *			- returns the current value of speed
+ *			- returns the current value of speed in mph, Q8.8 fixed point
  */
-float GetSpeed();
+ufix8_8_t GetSpeed();
 
 /** Returns the current cadence value at the time the function is called
  *
  *  @returns
- *			- returns the current value of cadence
+ *			- returns the current value of cadence in rpm, Q8.8 fixed point
  */
-float GetCadence();
+ufix8_8_t GetCadence();
 
 /** Returns the current tick value at the time the function is called.
  *  Ticks are the amount of times a magnet passes-through the tire hall
- *  effect sensor.  This directly translates to speed.
+ *  effect sensor each second.  This directly translates to speed.  In period
+ *  mode this is the rounded rate measured over the last rotation.
  *
  *	@returns
  *			- returns the current value of ticks
  */
 uint8_t GetTireTicks();
 
+/** Copies the sensor values into snapshot without disabling interrupts.  The
+ *  copy is retried until no hall effect interrupt wrote in the middle of it,
+ *  so multi-byte values are never torn.  The interrupts only store raw edge
+ *  timing, so the fixed point divisions are done here.  Safe to call from 
+ *  main and from other interrupts.
+ *
+ *  @par Parameters
+ *				-@a snapshot = structure to copy the sensor values into.
+ */
+void GetSensorSnapshot(SensorSnapshot* snapshot);
+
+/** Clears the shift flag, but only if no new data arrived since the snapshot
+ *  with the given sequence was taken.  Otherwise the flag stays set so the 
+ *  new data is not lost.
+ *
+ *  @par Parameters
+ *				-@a sequence = sequence of the snapshot that was acted on.
+ */
+void ClearShiftFlag(uint8_t sequence);
+
+/** Returns how long the tire has not moved, in whole Timer1 windows.  Any 
+ *  edge on the tire sensor starts it over, it stops counting at 65535.
+ *
+ *	@returns
+ *			- returns the seconds since the last tire edge
+ */
+uint16_t GetTireIdleSeconds();
+
+/** Starts the tire idle time over, used after waking from power down since
+ *  Timer1 does not run while the AtMega128 is powered down.
+ */
+void ClearTireIdle();
 
 #endif /* HALL_EFFECT_H */
 /** @} */ /* hall_effect */
\ No newline at end of file
@@ -8,7 +8,15 @@
  *
  * This source file provides the functions that manage the I2C/TWI  
  * communication protocol.  Provides functions for Write, Read, Burst 
- * read/write, start, stop, ACK, NACK and status.
+ * read/write and status.
+ *
+ * The bus is run from the TWI interrupt.  Transactions are queued with 
+ * TWISubmit and finish in the background, the Read and Write functions
+ * queue one and wait for it.
+ *
+ * A step that doesn't finish within TWI_TIMEOUT, e.g. because the MPU6050
+ * holds SDA low or a connector came loose, fails the transaction and the 
+ * bus is recovered, so a sensor fault can't stall the main loop.
  *
  */
  
@@ -16,57 +24,211 @@
 /* INCLUDES                                                                   */
 /*----------------------------------------------------------------------------*/
 #include "i2c.h"
+#include "timebase.h"
 
 /*----------------------------------------------------------------------------*/
 /* MACROS                                                                     */
 /*----------------------------------------------------------------------------*/
 #define TWI_READ_BIT  0       // Bit position for R/W bit in "address byte".
 #define TWI_ADR_BITS  1       // Bit position for LSB of the slave address bits in the init byte.
-#define TRUE          1
-#define FALSE         0
+#define TWI_WRITE     0
+#define TWI_READ      1
+
+/* master status codes, TWSR with the prescaler bits masked */
+#define TWI_START         0x08
+#define TWI_REP_START     0x10
+#define TWI_SLA_W_ACK     0x18
+#define TWI_DATA_W_ACK    0x28
+#define TWI_SLA_R_ACK     0x40
+#define TWI_DATA_R_ACK    0x50
+#define TWI_DATA_R_NACK   0x58
+#define TWI_BUS_ERROR     0x00
+
+/* Timeout of one bus step in us.  One byte takes 23us at 400kHz. */
+#define TWI_TIMEOUT       2000UL  /* 2ms */
+
+#define TWI_SCL           0       /* PD0 */
+#define TWI_SDA           1       /* PD1 */
+#define TWI_HALF_BIT      80      /* cycles, 5us, 100kHz recovery clock */
+
+/* TWCR values, each one also clears TWINT to start the next bus step */
+#define TWI_GO        ((1<<TWINT)|(1<<TWEN)|(1<<TWIE))
+#define TWI_GO_ACK    (TWI_GO|(1<<TWEA))
+#define TWI_GO_START  (TWI_GO|(1<<TWSTA))
+#define TWI_GO_STOP   ((1<<TWINT)|(1<<TWEN)|(1<<TWSTO))
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+/* Transactions waiting for the bus, twiHead is the one on the bus.  Only 
+   changed with interrupts off. */
+twi_transaction* twiHead = 0;
+twi_transaction* twiTail = 0;
+uint8_t twiIndex;       /* data bytes of twiHead moved so far */
+uint32_t twiStamp;      /* NowUs() when the current bus step started */
+twi_failures twiFailures = {0, 0, 0, 0};
 
 /*----------------------------------------------------------------------------*/
 /* FUNCTIONS                                                                  */
 /*----------------------------------------------------------------------------*/
 
-static void TWIStart()
+static uint8_t TWIGetStatus()
 {
-    TWCR = (1<<TWINT)|(1<<TWSTA)|(1<<TWEN);
-    while ((TWCR & (1<<TWINT)) == 0);
+    uint8_t status;
+    //mask status
+    status = TWSR & 0xF8;
+    return status;
 }
 
-static void TWIStop()
+/* Notes the start of a bus step for the timeout */
+static void TWIStamp(void)
 {
-    TWCR = (1<<TWINT)|(1<<TWSTO)|(1<<TWEN);
+    twiStamp = NowUs();
 }
 
-static void TWIWrite(uint8_t u8data)
+/* Ends the transaction on the bus and starts the next one.  STOP and START 
+   in one write makes the TWI send the STOP first. */
+static void TWIFinish(twi_state_t state)
 {
-    TWDR = u8data;
-    TWCR = (1<<TWINT)|(1<<TWEN);
-    while ((TWCR & (1<<TWINT)) == 0);
+    twi_transaction* done = twiHead;
+    
+    twiHead = done->next;
+    if(twiHead == 0)
+        twiTail = 0;
+    
+    twiIndex = 0;
+    if(twiHead != 0)
+    {
+        twiHead->state = TWI_BUSY;
+        TWIStamp();
+        TWCR = TWI_GO_STOP | (1<<TWSTA) | (1<<TWIE);
+    }
+    else
+        TWCR = TWI_GO_STOP;
+    
+    done->state = state;
+    if(done->callback != 0)
+        done->callback(done);
 }
 
-static uint8_t TWIReadACK()
+/* Frees a stuck bus and fails the transaction on it.  A device that holds
+   SDA low is waiting to clock out the rest of a byte, so SCL is toggled by 
+   hand until it lets go, at most 9 times, then a STOP is sent and the TWI 
+   is started again.  Runs with interrupts off, about 100us. */
+static void TWIRecover(void)
 {
-    TWCR = (1<<TWINT)|(1<<TWEN)|(1<<TWEA);
-    while ((TWCR & (1<<TWINT)) == 0);
-    return TWDR;
+    uint8_t i;
+    
+    twiFailures.recoveries++;
+    TWCR = 0;                                   /* pins back to PORTD */
+    PORTD &= ~((1<<TWI_SCL)|(1<<TWI_SDA));
+    DDRD &= ~(1<<TWI_SDA);                      /* SDA released        */
+    
+    for(i = 0; i < 9 && !(PIND & (1<<TWI_SDA)); ++i)
+    {
+        DDRD |= (1<<TWI_SCL);                   /* SCL low             */
+        __delay_cycles(TWI_HALF_BIT);
+        DDRD &= ~(1<<TWI_SCL);                  /* SCL released        */
+        __delay_cycles(TWI_HALF_BIT);
+    }
+    
+    /* STOP: SDA goes high while SCL is high */
+    DDRD |= (1<<TWI_SCL);
+    DDRD |= (1<<TWI_SDA);
+    __delay_cycles(TWI_HALF_BIT);
+    DDRD &= ~(1<<TWI_SCL);
+    __delay_cycles(TWI_HALF_BIT);
+    DDRD &= ~(1<<TWI_SDA);
+    __delay_cycles(TWI_HALF_BIT);
+    
+    TWIInit();
+    if(twiHead != 0)
+        TWIFinish(TWI_ERROR);
 }
 
-static uint8_t TWIReadNACK()
+/* Recovers the bus when the current step has taken longer than 
+   TWI_TIMEOUT */
+static __monitor void TWICheckTimeout(void)
 {
-    TWCR = (1<<TWINT)|(1<<TWEN);
-    while ((TWCR & (1<<TWINT)) == 0);
-    return TWDR;
+    if(twiHead == 0)
+        return;
+    
+    if(NowUs() - twiStamp > TWI_TIMEOUT)
+    {
+        twiFailures.timeouts++;
+        TWIRecover();
+    }
 }
 
-static uint8_t TWIGetStatus()
+/* Moves the transaction on the bus one step on, called once per TWINT */
+static void TWIStep(void)
 {
-    uint8_t status;
-    //mask status
-    status = TWSR & 0xF8;
-    return status;
+    twi_transaction* t = twiHead;
+    uint8_t status = TWIGetStatus();
+    
+    TWIStamp();
+    switch(status)
+    {
+    case TWI_START:
+        TWDR = (t->addr<<TWI_ADR_BITS) | (TWI_WRITE<<TWI_READ_BIT);
+        TWCR = TWI_GO;
+        break;
+    
+    case TWI_SLA_W_ACK:
+        TWDR = t->reg;
+        TWCR = TWI_GO;
+        break;
+    
+    case TWI_DATA_W_ACK:
+        if(t->read)
+            TWCR = TWI_GO_START;  /* repeated start for the read */
+        else if(twiIndex < t->length)
+        {
+            TWDR = t->buffer[twiIndex++];
+            TWCR = TWI_GO;
+        }
+        else
+            TWIFinish(TWI_DONE);
+        break;
+    
+    case TWI_REP_START:
+        TWDR = (t->addr<<TWI_ADR_BITS) | (TWI_READ<<TWI_READ_BIT);
+        TWCR = TWI_GO;
+        break;
+    
+    case TWI_SLA_R_ACK:
+        /* ACK every byte but the last */
+        TWCR = (t->length > 1) ? TWI_GO_ACK : TWI_GO;
+        break;
+    
+    case TWI_DATA_R_ACK:
+        t->buffer[twiIndex++] = TWDR;
+        TWCR = (twiIndex < t->length - 1) ? TWI_GO_ACK : TWI_GO;
+        break;
+    
+    case TWI_DATA_R_NACK:
+        t->buffer[twiIndex++] = TWDR;
+        TWIFinish(TWI_DONE);
+        break;
+    
+    case TWI_BUS_ERROR:
+        /* illegal START or STOP on the bus */
+        twiFailures.busErrors++;
+        TWIRecover();
+        break;
+    
+    default:
+        /* NACK from the device or lost arbitration */
+        twiFailures.nacks++;
+        TWIFinish(TWI_ERROR);
+        break;
+    }
+}
+
+#pragma vector = TWI_vect
+__interrupt void ISR_TWI(void)
+{
+    TWIStep();
 }
 
 void TWIInit()
@@ -78,61 +240,103 @@ void TWIInit()
     TWCR = (1<<TWEN);
 }
 
-void TWIWriteByte(uint8_t reg, uint8_t data)
+__monitor bool_t TWISubmit(twi_transaction* transaction)
 {
-	TWIStart();
-	TWIWrite((MPU6050_I2C_ADDRESS<<TWI_ADR_BITS) | (FALSE<<TWI_READ_BIT));
-	TWIWrite(reg);
-	TWIWrite(data);
-	TWIStop();
+    if(transaction->state == TWI_QUEUED || transaction->state == TWI_BUSY)
+        return FALSE;
+    
+    transaction->next = 0;
+    if(twiHead == 0)
+    {
+        twiHead = transaction;
+        twiTail = transaction;
+        twiIndex = 0;
+        transaction->state = TWI_BUSY;
+        TWIStamp();
+        TWCR = TWI_GO_START;
+    }
+    else
+    {
+        twiTail->next = transaction;
+        twiTail = transaction;
+        transaction->state = TWI_QUEUED;
+    }
+    return TRUE;
 }
 
-void TWIWriteBurst(uint8_t addr, uint8_t reg, uint8_t const* data, uint8_t length)
+bool_t TWIFinished(twi_transaction const* transaction)
 {
-	uint8_t i;
-	
-	TWIStart();
-	TWIWrite((addr<<TWI_ADR_BITS) | (FALSE<<TWI_READ_BIT));
-	TWIWrite(reg);
+    if(transaction->state == TWI_DONE || transaction->state == TWI_ERROR)
+        return TRUE;
+    return FALSE;
+}
+
+void TWIPoll(void)
+{
+    TWICheckTimeout();
+}
+
+__monitor void TWIGetFailures(twi_failures* failures)
+{
+    *failures = twiFailures;
+}
+
+/* Waits for a transaction.  With interrupts off, e.g. when called from an
+   interrupt, the TWI interrupt can't run, so the steps are run from here. */
+static void TWIWait(twi_transaction* transaction)
+{
+    while(TWIFinished(transaction) != TRUE)
+    {
+        if(!(SREG & 0x80) && (TWCR & (1<<TWINT)))
+            TWIStep();
+        TWICheckTimeout();
+    }
+}
+
+bool_t TWIWriteByte(uint8_t reg, uint8_t data)
+{
+	return TWIWriteBurst(MPU6050_I2C_ADDRESS, reg, &data, 1);
+}
+
+bool_t TWIWriteBurst(uint8_t addr, uint8_t reg, uint8_t const* data, uint8_t length)
+{
+	twi_transaction t;
 	
-	for(i=0; i < length; ++i)
-	{
-		TWIWrite(data[i]);
-	}
+	t.addr = addr;
+	t.reg = reg;
+	t.buffer = (uint8_t*)data;
+	t.length = length;
+	t.read = TWI_WRITE;
+	t.callback = 0;
+	t.state = TWI_IDLE;
 	
-	TWIStop();
+	TWISubmit(&t);
+	TWIWait(&t);
+	return (t.state == TWI_DONE) ? TRUE : FALSE;
 }
 
 uint8_t TWIReadByte(uint8_t reg)
 {
-	uint8_t data;
-	TWIStart();
-	TWIWrite((MPU6050_I2C_ADDRESS<<TWI_ADR_BITS) | (FALSE<<TWI_READ_BIT));
-	TWIWrite(reg);
-	TWIStart();
-	TWIWrite((MPU6050_I2C_ADDRESS<<TWI_ADR_BITS) | (TRUE<<TWI_READ_BIT));
-	data = TWIReadNACK();
-	TWIStop();
+	uint8_t data = 0;
+	TWIReadBurst(MPU6050_I2C_ADDRESS, reg, &data, 1);
 	
 	return data;
 }
 
-void TWIReadBurst(uint8_t addr, uint8_t reg, uint8_t* data, uint8_t length)
+bool_t TWIReadBurst(uint8_t addr, uint8_t reg, uint8_t* data, uint8_t length)
 {
-	uint8_t i;
+	twi_transaction t;
 	
-	TWIStart();
-	TWIWrite((addr<<TWI_ADR_BITS) | (FALSE<<TWI_READ_BIT));
-	TWIWrite(reg);
-	TWIStart();
-	TWIWrite((addr<<TWI_ADR_BITS) | (TRUE<<TWI_READ_BIT));
+	t.addr = addr;
+	t.reg = reg;
+	t.buffer = data;
+	t.length = length;
+	t.read = TWI_READ;
+	t.callback = 0;
+	t.state = TWI_IDLE;
 	
-	for(i=0; i < length-1; ++i)
-	{
-          data[i] = TWIReadACK();
-	}
-        
-        data[length-1] = TWIReadNACK();
-	TWIStop();
-}
-/** @} */ /* i2c */
\ No newline at end of file
+	TWISubmit(&t);
+	TWIWait(&t);
+	return (t.state == TWI_DONE) ? TRUE : FALSE;
+}
+/** @} */ /* i2c */
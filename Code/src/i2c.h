@@ -24,37 +24,38 @@
 #include "common.h"
 
 /*----------------------------------------------------------------------------*/
-/* Function Prototypes                                                        */
+/* Typedefs                                                                   */
 /*----------------------------------------------------------------------------*/
-/** Send Start Signal */
-static void TWIStart();
-
-/** Send Stop Signal */
-static void TWIStop();
+typedef enum {TWI_IDLE = 0, TWI_QUEUED, TWI_BUSY, TWI_DONE, TWI_ERROR} twi_state_t;
 
-/** Write one byte to the TWI data register
- *
- *  @par Parameters
- * 			-@a data = one byte to be stored in the register
- *
+/** One register read or write.  The caller owns the descriptor and the 
+ *  buffer, both have to stay valid until the state is TWI_DONE or TWI_ERROR.
  */
-static void TWIWrite(uint8_t data);
+typedef struct twi_transaction
+{
+  uint8_t  addr;      /* 7-bit device address                          */
+  uint8_t  reg;       /* first register                                */
+  uint8_t* buffer;    /* data to write or room for the data read       */
+  uint8_t  length;    /* number of data bytes, at least 1              */
+  uint8_t  read;      /* 1 to read from the device, 0 to write to it   */
+  /* called from the TWI interrupt once the transaction is over, may be 0 */
+  void (*callback)(struct twi_transaction* transaction);
+  volatile twi_state_t state;
+  struct twi_transaction* next;
+} twi_transaction;
 
-/** Read an ACK is received
- *
- * @returns
- *		   -Returns the NACK received. 
- */
-static uint8_t TWIReadACK();
-
-/** Read a NACK is received
- *  
- * @returns
- *		   -Returns the NACK received. 
- *
- */
-static uint8_t TWIReadNACK();
+/** Failure counters, they wrap around */
+typedef struct
+{
+  uint16_t nacks;       /* address or data not acknowledged, lost arbitration */
+  uint16_t busErrors;   /* illegal START or STOP seen on the bus               */
+  uint16_t timeouts;    /* bus steps that took longer than the timeout         */
+  uint16_t recoveries;  /* times the bus was cleared and the TWI restarted     */
+} twi_failures;
 
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
 /** Will return the status of the Status Register
  *
  * @returns
@@ -68,6 +69,44 @@ static uint8_t TWIGetStatus();
  */
 void TWIInit();
 
+/** Queues a transaction and returns straight away.  The TWI interrupt runs 
+ *  the transactions one after the other in the order they were queued, 
+ *  state and callback tell when this one is over.
+ *
+ * @par Parameters
+ *		   -@a transaction = filled in descriptor, the state and next fields 
+ *		                     are set here.
+ *
+ * @returns
+ *		   -Returns FALSE when the descriptor is still queued or running from 
+ *		    an earlier call, TRUE otherwise.
+ */
+bool_t TWISubmit(twi_transaction* transaction);
+
+/** A function to check whether a transaction is over.
+ *
+ * @par Parameters
+ *		   -@a transaction = descriptor passed to TWISubmit.
+ *
+ * @returns
+ *		   -Returns TRUE once the transaction is done or has failed.
+ */
+bool_t TWIFinished(twi_transaction const* transaction);
+
+/** Checks the transaction on the bus for a timeout and recovers the bus if 
+ *  it is stuck.  Has to be called regularly from the main loop, the blocking
+ *  functions also check while they wait.
+ */
+void TWIPoll(void);
+
+/** A function to read the failure counters, used to tell a missing or 
+ *  faulty sensor from a working one.
+ *
+ * @par Parameters
+ *		   -@a failures = filled in with the counters.
+ */
+void TWIGetFailures(twi_failures* failures);
+
 /** Read an amount of bytes starting from a register address until the maximum
  *  amount is reached.  The register that is read is incremented by 1 after each  
  *  read. This is used to read from registers that have an address difference of 
@@ -88,8 +127,15 @@ void TWIInit();
  *			-@a length = maximum amount of registers to be read from.
  *
  * @param [Out] data = The array to hold the data recieved
+ *
+ * @par Assumptions
+ *		   -Queues the read behind any other transaction and waits for it.
+ *
+ * @returns
+ *		   -Returns TRUE when the read worked, the data is left as it was
+ *		    otherwise.
  */
-void TWIReadBurst(uint8_t addr, uint8_t reg, uint8_t* data, uint8_t length);
+bool_t TWIReadBurst(uint8_t addr, uint8_t reg, uint8_t* data, uint8_t length);
 
 /** Read one byte from a register
  *
@@ -101,7 +147,8 @@ void TWIReadBurst(uint8_t addr, uint8_t reg, uint8_t* data, uint8_t length);
  *		   -The address the byte is sent to is defaulted to the MPU6050 address
  *
  * @returns
- *		   -Returns the byte received from the requested register.
+ *		   -Returns the byte received from the requested register, 0 when the
+ *		    read failed.
  */
 uint8_t TWIReadByte(uint8_t reg);
 
@@ -124,8 +171,13 @@ uint8_t TWIReadByte(uint8_t reg);
  *				      incremented by one along with reg.
  *		   -@a length = maximum amount of registers to be overwritten.
  *
+ * @par Assumptions
+ *		   -Queues the write behind any other transaction and waits for it.
+ *
+ * @returns
+ *		   -Returns TRUE when the write worked.
  */
-void TWIWriteBurst(uint8_t addr, uint8_t reg, uint8_t const* data, uint8_t length);
+bool_t TWIWriteBurst(uint8_t addr, uint8_t reg, uint8_t const* data, uint8_t length);
 
 /** Write one byte to a register
  *	
@@ -135,8 +187,11 @@ void TWIWriteBurst(uint8_t addr, uint8_t reg, uint8_t const* data, uint8_t lengt
  *
  * @par Assumptions
  *		   -The address the byte is sent to is defaulted to the MPU6050 address
+ *
+ * @returns
+ *		   -Returns TRUE when the write worked.
  */
-void TWIWriteByte(uint8_t reg, uint8_t data);
+bool_t TWIWriteByte(uint8_t reg, uint8_t data);
 
 
 #endif /* I2C_H */
@@ -0,0 +1,44 @@
+/**
+ * @file   incline.h  <br>
+ * @brief  Header file for the road gradient estimate. <br>
+ * @defgroup incline Incline
+ * @{
+ *
+ * This header file contains the function prototypes used to read the 
+ * gradient of the road.  The pitch of the bike is estimated from the 
+ * MPU6050 samples with a fixed point complementary filter: the gyro is 
+ * integrated for the short term and the pull of gravity on the forward 
+ * axis of the accelerometer corrects its drift over about two seconds.
+ *
+ * The axes used depend on how the MPU6050 is mounted and are set in 
+ * user_config.h.
+ *
+ */
+ 
+/* Used to prevent multiple inclusion of the header file */
+#ifndef INCLINE_H
+#define INCLINE_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Runs the filter on the MPU6050 samples that came in since the last call.
+ *  Has to be called from the main loop, the samples arrive at 62.5Hz.
+ */
+void InclinePoll();
+
+/** Returns the gradient of the road.
+ *
+ *  @returns
+ *			- returns the gradient in percent, Q8.8 fixed point, positive 
+ *			  uphill.  0 until the first sample has arrived.
+ */
+fix8_8_t GetGradient();
+
+#endif /* INCLINE_H */
+/** @} */ /* incline */
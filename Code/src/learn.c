@@ -0,0 +1,195 @@
+/**
+ * @file   learn.c  <br>
+ * @brief  Gear learning source file  <br>
+ * @defgroup learn Learning
+ * @{
+ *
+ * This source file keeps the cadence histogram, 8 bins of 10rpm from 50rpm
+ * for each speed, as 4 bit counts packed two to a byte.  When a count is
+ * full the whole speed is halved, so older samples fade and the histogram
+ * follows the rider.  The cadence learned for a speed is the mean of its
+ * histogram and is worked out again whenever the speed gets a sample.
+ *
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "learn.h"
+#include "eeprom_sync.h"
+#include "gearing.h"
+#include "hall_effect.h"
+#include "servos.h"
+#include "timebase.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define SPEED_BUCKETS   16
+#define LEARN_BINS      8
+#define LEARN_BASE      50    /* rpm at the bottom of bin 0            */
+#define LEARN_STEP      10    /* rpm per bin                           */
+#define LEARN_BYTES     (SPEED_BUCKETS * LEARN_BINS / 2)
+#define LEARN_FULL      15
+#define LEARN_VALID     0xA5
+#define LEARN_SAVE_MS   (LEARN_SAVE_MINUTES * 60000UL)
+#define LEARN_PEDALING  FIX8_8(48)  /* same as the shift warning */
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+__eeprom static uint8_t histogramEE[LEARN_BYTES];
+__eeprom static uint8_t learnValidEE;
+static uint8_t const learnValid = LEARN_VALID;
+
+uint8_t histogram[LEARN_BYTES];
+uint8_t learned[SPEED_BUCKETS];  /* cadence of each speed, 0 for none    */
+bool_t  samplePending = FALSE;
+uint32_t sampleDue;              /* NowMs() the sample is taken at       */
+bool_t  unsaved = FALSE;         /* histogram differs from EEprom        */
+uint32_t lastSave = 0;
+
+/*----------------------------------------------------------------------------*/
+/* FUNCTIONS                                                                  */
+/*----------------------------------------------------------------------------*/
+static uint8_t BinCount(uint8_t bucket, uint8_t bin)
+{
+  uint8_t pair = histogram[bucket * (LEARN_BINS / 2) + bin / 2];
+
+  return (bin & 1) ? (pair >> 4) : (pair & 0x0F);
+}
+
+/* Works out the mean cadence of one speed */
+static void LearnBucket(uint8_t bucket)
+{
+  uint16_t total = 0;
+  uint16_t sum = 0;
+  uint8_t count;
+  uint8_t bin;
+
+  for(bin = 0; bin < LEARN_BINS; ++bin)
+  {
+    count = BinCount(bucket, bin);
+    total += count;
+    sum += count * bin;
+  }
+
+  if(total < LEARN_MIN_SAMPLES)
+    learned[bucket] = 0;
+  else
+    learned[bucket] = LEARN_BASE + LEARN_STEP / 2
+                      + (sum * LEARN_STEP + total / 2) / total;
+}
+
+void InitLearn(void)
+{
+  uint8_t i;
+
+  if(learnValidEE != LEARN_VALID)
+    return;  /* nothing learned yet */
+  for(i = 0; i < LEARN_BYTES; ++i)
+    histogram[i] = histogramEE[i];
+  for(i = 0; i < SPEED_BUCKETS; ++i)
+    LearnBucket(i);
+}
+
+/* Counts the cadence of the gear the rider is in at the current speed */
+static void LearnSample(void)
+{
+  ufix8_8_t speed = GetSpeed();
+  uint8_t bucket = FIX8_8_INT(speed) / LEARN_BUCKET_MPH;
+  uint8_t rpm;
+  uint8_t bin;
+  uint8_t* pair;
+  uint8_t i;
+
+  if(GetCadence() <= LEARN_PEDALING)
+    return;
+  if(bucket >= SPEED_BUCKETS)
+    bucket = SPEED_BUCKETS - 1;
+
+  rpm = FIX8_8_INT(GearCadence(speed, GEAR(GetFrontGear(), GetRearGear())));
+  bin = (rpm < LEARN_BASE) ? 0 : (rpm - LEARN_BASE) / LEARN_STEP;
+  if(bin >= LEARN_BINS)
+    bin = LEARN_BINS - 1;
+
+  if(BinCount(bucket, bin) == LEARN_FULL)
+  {
+    pair = &histogram[bucket * (LEARN_BINS / 2)];
+    for(i = 0; i < LEARN_BINS / 2; ++i)
+      pair[i] = (pair[i] >> 1) & 0x77;  /* halves both counts */
+  }
+  histogram[bucket * (LEARN_BINS / 2) + bin / 2] += (bin & 1) ? 0x10 : 0x01;
+
+  LearnBucket(bucket);
+  unsaved = TRUE;
+}
+
+/* Writes the first byte that changed, never waiting for EEprom.  Returns 
+   TRUE once EEprom holds the whole histogram.  The valid mark goes last, so
+   a first save cut short leaves nothing half written in use. */
+static bool_t LearnWrite(void)
+{
+  if(EEpromSync(histogramEE, histogram, LEARN_BYTES) == FALSE)
+    return FALSE;
+  return EEpromSync(&learnValidEE, &learnValid, 1);
+}
+
+/* Writes one more byte, marks the histogram saved once all are */
+static bool_t LearnSaveStep(void)
+{
+  if(unsaved == FALSE)
+    return TRUE;
+  if(LearnWrite() == FALSE)
+    return FALSE;
+  unsaved = FALSE;
+  lastSave = NowMs();
+  return TRUE;
+}
+
+void LearnShift(void)
+{
+  sampleDue = NowMs() + LEARN_DELAY_MS;
+  samplePending = TRUE;
+}
+
+void LearnPoll(bool_t ready)
+{
+  if(samplePending == TRUE && (int32_t)(NowMs() - sampleDue) >= 0)
+  {
+    samplePending = FALSE;
+    if(ready == TRUE)
+      LearnSample();
+  }
+
+  if(NowMs() - lastSave >= LEARN_SAVE_MS)
+    LearnSaveStep();
+}
+
+uint8_t LearnedCadence(ufix8_8_t speed)
+{
+  uint8_t bucket = FIX8_8_INT(speed) / LEARN_BUCKET_MPH;
+
+  if(bucket >= SPEED_BUCKETS)
+    bucket = SPEED_BUCKETS - 1;
+  return learned[bucket];
+}
+
+bool_t LearnFlush(void)
+{
+  return LearnSaveStep();
+}
+
+void LearnReset(void)
+{
+  uint8_t i;
+
+  for(i = 0; i < LEARN_BYTES; ++i)
+    histogram[i] = 0;
+  for(i = 0; i < SPEED_BUCKETS; ++i)
+    learned[i] = 0;
+  samplePending = FALSE;
+  unsaved = TRUE;
+}
+
+/** @} */ /* learn */
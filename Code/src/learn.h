@@ -0,0 +1,75 @@
+/**
+ * @file   learn.h  <br>
+ * @brief  Header file for the gear learning. <br>
+ * @defgroup learn Learning
+ * @{
+ *
+ * This header file contains the function prototypes used to learn the
+ * cadence the rider likes from the gears picked in manual mode.  A while
+ * after the last manual shift the cadence of the gear the rider stayed in
+ * is counted in a histogram for the speed, one per LEARN_BUCKET_MPH.  Once
+ * a speed has LEARN_MIN_SAMPLES, automatic mode aims for the learned
+ * cadence there instead of the middle of the band.
+ *
+ * The histogram is kept in EEprom, so the learning carries over between
+ * rides.  Only bytes that changed are written, at most once every
+ * LEARN_SAVE_MINUTES while riding and before shutting down or parking.  An
+ * EEprom write takes 8.5ms, so a byte is only written when the last one is
+ * done, one per call, and nothing ever waits for EEprom.
+ *
+ */
+
+/* Used to prevent multiple inclusion of the header file */
+#ifndef LEARN_H
+#define LEARN_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Loads the histogram from EEprom, nothing is learned on the first boot */
+void InitLearn(void);
+
+/** Tells the learning a manual shift was made.  The gear is learned
+ *  LEARN_DELAY_MS after the last one, so gears passed through on the way
+ *  are not.
+ */
+void LearnShift(void);
+
+/** Takes the sample once it is due and writes the histogram to EEprom when
+ *  it is time to.  Called from the main loop.
+ *
+ *  @par Parameters
+ *				-@a ready = TRUE in manual mode while no shift runs, a sample
+ *				            due while FALSE is dropped.
+ */
+void LearnPoll(bool_t ready);
+
+/** Returns the cadence learned for a speed.
+ *
+ *  @par Parameters
+ *				-@a speed = speed in mph, Q8.8 fixed point.
+ *
+ *  @returns
+ *			- returns the cadence in rpm, 0 while too little is learned
+ */
+uint8_t LearnedCadence(ufix8_8_t speed);
+
+/** Writes the next byte of the histogram not saved yet, without waiting
+ *  for the save interval.  Called until it returns TRUE before shutting
+ *  down or parking, with a few ms between calls.
+ *
+ *	@returns
+ *			-Returns TRUE once EEprom holds everything learned.
+ */
+bool_t LearnFlush(void);
+
+/** Forgets everything learned, for a new rider. */
+void LearnReset(void);
+
+#endif /* LEARN_H */
+/** @} */ /* learn */
@@ -0,0 +1,131 @@
+/**
+ * @file   led.c  <br>
+ * @brief  Handlebar LED source file  <br>
+ * @defgroup led LED
+ * @{
+ *
+ * This source file plays the LED patterns from the system tick.  The tick
+ * interrupt counts down the current phase and runs the PWM, main only
+ * starts patterns and sets the steady level.  PORTE is within reach of
+ * sbi and cbi, so setting the LED bit in the interrupt cannot undo a write
+ * main makes to the other PORTE pins.
+ *
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "led.h"
+#include "scheduler.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define LED_ON()     (LED_PORT |=  (1 << LED_PIN))
+#define LED_OFF()    (LED_PORT &= ~(1 << LED_PIN))
+
+/*----------------------------------------------------------------------------*/
+/* Patterns                                                                   */
+/*----------------------------------------------------------------------------*/
+/*                                          on   off  repeat brightness */
+led_pattern __flash const ledShiftUp     = {120, 120, 2,     LED_LEVELS};
+led_pattern __flash const ledShiftDown   = {400, 200, 1,     LED_LEVELS};
+led_pattern __flash const ledLowCadence  = {200, 400, 3,     1};
+led_pattern __flash const ledShutdown    = {500, 500, 4,     LED_LEVELS};
+led_pattern __flash const ledCalibrating = {100, 200, 10,    2};
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+uint8_t  steadyLevel = 0;          /* level shown while no pattern plays */
+volatile uint8_t  ledLevel = 0;    /* level shown now                    */
+volatile uint16_t phaseTicks = 0;  /* ticks left of the phase, 0 idle    */
+uint8_t  pwmStep = 0;
+uint16_t onTicks;                  /* the pattern playing, in ticks      */
+uint16_t offTicks;
+uint8_t  onLevel;
+uint8_t  cyclesLeft;               /* cycles left, counting this one     */
+bool_t   lit;                      /* the phase playing is the on time   */
+
+/*----------------------------------------------------------------------------*/
+/* FUNCTIONS                                                                  */
+/*----------------------------------------------------------------------------*/
+void InitLed(void)
+{
+  LED_OFF();
+  LED_DDR |= (1 << LED_PIN);
+}
+
+/* Phase length in ticks, a phase of 0 would end the pattern early */
+static uint16_t LedTicks(uint16_t ms)
+{
+  uint16_t ticks = ms / TICK_MS;
+
+  return (ticks == 0) ? 1 : ticks;
+}
+
+/* Moves on to the next phase once the current one is over */
+static void LedPhase(void)
+{
+  if(lit == TRUE)
+  {
+    lit = FALSE;
+    ledLevel = 0;
+    phaseTicks = offTicks;
+  }
+  else if(--cyclesLeft != 0)
+  {
+    lit = TRUE;
+    ledLevel = onLevel;
+    phaseTicks = onTicks;
+  }
+  else
+    ledLevel = steadyLevel;  /* phaseTicks stays 0, the pattern is over */
+}
+
+void LedTick(void)
+{
+  if(phaseTicks != 0 && --phaseTicks == 0)
+    LedPhase();
+
+  pwmStep = (pwmStep + 1) & (LED_LEVELS - 1);
+  if(pwmStep < ledLevel)
+    LED_ON();
+  else
+    LED_OFF();
+}
+
+__monitor void LedPlay(led_pattern __flash const* pattern)
+{
+  if(pattern->repeat == 0)
+    return;
+  onTicks = LedTicks(pattern->onMs);
+  offTicks = LedTicks(pattern->offMs);
+  onLevel = pattern->brightness;
+  cyclesLeft = pattern->repeat;
+  lit = TRUE;
+  ledLevel = onLevel;
+  phaseTicks = onTicks;
+}
+
+__monitor void LedSteady(uint8_t level)
+{
+  steadyLevel = level;
+  if(phaseTicks == 0)
+    ledLevel = level;
+}
+
+__monitor void LedStop(void)
+{
+  phaseTicks = 0;
+  steadyLevel = 0;
+  ledLevel = 0;
+  LED_OFF();
+}
+
+__monitor bool_t LedBusy(void)
+{
+  return (phaseTicks != 0) ? TRUE : FALSE;
+}
+
+/** @} */ /* led */
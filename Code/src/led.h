@@ -0,0 +1,92 @@
+/**
+ * @file   led.h  <br>
+ * @brief  Header file for the handlebar LED. <br>
+ * @defgroup led LED
+ * @{
+ *
+ * This header file contains the function prototypes and patterns of the
+ * handlebar LED on PORTE 7.  A pattern is played in the background by the
+ * 2ms system tick, so starting one returns straight away.
+ *
+ * A pattern is a number of on and off cycles, the LED shows the pattern's
+ * brightness for the on time and is dark for the off time.  Once the last
+ * cycle is over it goes back to its steady level, which is what main shows
+ * between patterns.  PORTE 7 has no timer output, so the brightness is a
+ * software PWM on the tick in LED_LEVELS steps.
+ *
+ */
+
+/* Used to prevent multiple inclusion of the header file */
+#ifndef LED_H
+#define LED_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define LED_LEVELS  4   /* full brightness, 8ms PWM period at the 2ms tick */
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+/** A pattern for the LED to play */
+typedef struct
+{
+  uint16_t onMs;        /* lit time of a cycle, rounded down to ticks   */
+  uint16_t offMs;       /* dark time of a cycle                         */
+  uint8_t  repeat;      /* cycles to play                               */
+  uint8_t  brightness;  /* lit level, 1 to LED_LEVELS                   */
+} led_pattern;
+
+/*----------------------------------------------------------------------------*/
+/* Patterns                                                                   */
+/*----------------------------------------------------------------------------*/
+extern led_pattern __flash const ledShiftUp;      /* two quick flashes      */
+extern led_pattern __flash const ledShiftDown;    /* one long flash         */
+extern led_pattern __flash const ledLowCadence;   /* three slow dim flashes */
+extern led_pattern __flash const ledShutdown;     /* four 1 second flashes  */
+extern led_pattern __flash const ledCalibrating;  /* dim flashes for 3s     */
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Sets PORTE 7 to an output with the LED off */
+void InitLed(void);
+
+/** Advances the pattern and the PWM, called from the Timer0 interrupt
+ *  every TICK_MS.
+ */
+void LedTick(void);
+
+/** Starts a pattern, replacing the one playing.
+ *
+ *  @par Parameters
+ *				-@a pattern = pattern to play.
+ */
+void LedPlay(led_pattern __flash const* pattern);
+
+/** Sets the level the LED shows while no pattern plays.
+ *
+ *  @par Parameters
+ *				-@a level = brightness, 0 for off to LED_LEVELS.
+ */
+void LedSteady(uint8_t level);
+
+/** Ends the pattern playing and turns the LED off straight away, for
+ *  when the tick is about to stop.
+ */
+void LedStop(void);
+
+/** A function used to check whether a pattern is still playing.
+ *
+ *	@returns
+ *			-Returns TRUE until the last cycle of the pattern is over.
+ */
+bool_t LedBusy(void);
+
+#endif /* LED_H */
+/** @} */ /* led */
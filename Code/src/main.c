@@ -10,8 +10,8 @@
  * library.  It uses all of our functions and contains the algorithm for
  * top level control along with manual and automatic modes.
  *
- * Included in this file is all of the code for the LED located on the 
- * handlebar.  This this is connected to the AtMega128 on PORTE 7.
+ * The handlebar LED on PORTE 7 shows the mode, the shifts and the 
+ * warnings through the patterns of led.c.
  *
  */
  
@@ -23,8 +23,15 @@
 /*----------------------------------------------------------------------------*/
 /* MACROS                                                                     */
 /*----------------------------------------------------------------------------*/
-#define LED_ON()     PORTE |=  (1 << 7);
-#define LED_OFF()    PORTE &= ~(1 << 7);
+/* hardest gears the gradient lets automatic mode use */
+#define HILL_GEAR    GEAR(1, 6)   /* same as HillShift */
+#define CLIMB_GEAR   GEAR(2, 5)
+
+#define SENSE_MS        10    /* MPU6050 samples arrive at 62.5Hz      */
+#define BUTTON_MS       10    /* gestures are recognized every 10ms    */
+#define TELEMETRY_MS    10
+#define LEARN_MS        250
+#define AUTO_SETTLE_MS  2000  /* wait after an automatic shift decision */
 
 /*----------------------------------------------------------------------------*/
 /* Global Data                                                                */
@@ -32,31 +39,46 @@
   uint8_t frontGear;
   uint8_t rearGear;
   uint8_t servoPos;
-  uint8_t ticks = 0;
-  uint8_t prev_ticks = 0;
   int16_t temp;
   bool_t hill = FALSE;
   bool_t warning = FALSE;
   Accel_stats accel;
-  extern bool_t shiftFlag;
-  /*table of values used to control automatic shifting, each position relates 
-    to a speed.*/
-  uint8_t rear_gear_table[32] = {6,6,6,6,6,6,5,6,6,5,4,3,3,2,2,3,3,2,2,2,1,1,1,1,1,1,1,1,1,1,1,1};
-  uint8_t front_gear_table[32] = {1,1,1,1,1,1,1,2,2,2,2,2,2,2,2,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3,3};
-  uint8_t shift_index = 0;
+  uint8_t climb_cap = NO_GEAR;  /*hardest gear allowed on the gradient*/
+  bool_t autoShifting = FALSE;
   power_stats pStats;
+  bool_t calibrate = FALSE;  /*set by the app to recalibrate the MPU6050*/
+  uint16_t wakeLatency = 0;  /*us from the last wake to ready*/
+  bool_t on = TRUE;          /*set to FALSE by the shutdown button*/
+  bool_t automatic = FALSE;  /*mode of operation, manual to start*/
   
 /*----------------------------------------------------------------------------*/
 /* Function Prototypes                                                        */
 /*----------------------------------------------------------------------------*/
 __eeprom static uint8_t frontEE;
 __eeprom static uint8_t rearEE;
+__eeprom static MPU_calibration imuEE;
+MPU_calibration imuCal;       /*calibration to store in EEprom*/
+bool_t calUnsaved = FALSE;    /*imuCal is not in EEprom yet*/
+bool_t calCleared = FALSE;    /*the valid mark in EEprom is cleared*/
 bool_t manual_mode(bool_t* automatic);
 bool_t automatic_mode(bool_t* automatic);
 void AutoShift();
 void SingleAutoShift();
-void FlashLedOff();
+void StartAutoShift(uint8_t gear);
+bool_t ClimbCheck();
+void SenseTask();
+void ButtonTask();
+void LearnTask();
+void SaveGears();
+bool_t FlushEEprom();
 uint8_t GetWarning();  
+void LoadCalibration();
+void CalibrateIMU();
+void CalibrateTask();
+bool_t CalibrationFlush();
+void RequestCalibration();
+void Park();
+uint16_t GetWakeLatency();
 
 /*----------------------------------------------------------------------------*/
 /* FUNCTIONS                                                                  */
@@ -64,55 +86,70 @@ uint8_t GetWarning();
 /**	The main function used to initialize our control values like: pStats, on,
  *  automatic, front and rear gears.  This will also call our initialization 
  *  functions for each device (buttons, servos, bluetooth, hall effect, 
- *  MPU6050).  The function will then loop while the value of on is true. In
- *  this loop, the pointer automatic will decide what mode we are in. Once 
- *  shutdown is pressed, the servos will be killed and the LEDs will flash to
- *  signify shutdown was activated.
+ *  MPU6050) and start the tasks.  The function will then sleep and run the
+ *  tasks that are due while the value of on is true.  Once shutdown is 
+ *  pressed, the servos will be killed and the LED will play the shutdown
+ *  pattern to signify shutdown was activated.
  *
  */
 int main()
 {
- bool_t on = TRUE; /*set system to on*/
+ bool_t saved;  /*learning is in EEprom*/
+
  pStats = ON;  /*set system to on*/
- bool_t automatic = FALSE; /*initialize to manual*/
  //frontEE = 1;  /*used to set the initial EEprom values.*/
  //rearEE = 6;
  frontGear = frontEE;  /*set the gears to the last written EEprom values*/
  rearGear = rearEE; 
 
  /*initialize all components*/
+ InitTimebase();
+ InitScheduler();
+ InitLed();
+ InitGearing();
+ InitLearn();
  InitButtons();
  InitServos(frontGear, rearGear);
  InitBluetooth();  
  InitHallEffect();
  Init_MPU6050();
+ MPUStartSampling();
+ LoadCalibration();
+  
+  TaskPeriodic(TASK_SENSE, SenseTask, SENSE_MS);
+  TaskPeriodic(TASK_BUTTONS, ButtonTask, BUTTON_MS);
+  TaskPeriodic(TASK_LEARN, LearnTask, LEARN_MS);
+  TaskPeriodic(TASK_TELEMETRY, BluetoothPoll, TELEMETRY_MS);
   
-  /*loop through manual or automatic modes until on = false 
-                                               (shutdown pressed)*/
+  /*run the tasks until on = false (shutdown pressed)*/
   while(on == TRUE)
   {
-    if(automatic == FALSE)
-    {
-      LED_OFF();
-      on = manual_mode(&automatic);
-    }
-    else
-    {
-      LED_ON();
-      on = automatic_mode(&automatic);
-    }
+    IdleSleep();
+    SchedulerRun();
   }
+  TaskCancel(TASK_BUTTONS);
+  TaskCancel(TASK_CALIBRATE);
+  TaskCancel(TASK_LEARN);
+  TaskCancel(TASK_SENSE);
+  TaskCancel(TASK_SHIFT);
   killServos();
-  FlashLedOff();
-  FlashLedOff();
-  __delay_cycles(8000000);
-  PORTE &= ~(1 << 7);
+  LedSteady(0);
+  LedPlay(&ledShutdown);
+  do
+  {
+    IdleSleep();
+    SchedulerRun();
+    saved = FlushEEprom();  /*one EEprom byte per pass*/
+  } while(LedBusy() == TRUE || saved == FALSE);
   pStats = OFF;
 }
 
-/** A function for manual mode control. This will wait for a button input 
- *  and react in one of seven ways: Front Gear Up, Front Gear Down, Rear 
- *  Gear Up, Rear Gear Down, Shutdown, Switch Mode and Hill Incoming.
+/** A function for manual mode control. This will take the next button 
+ *  event, if there is one, and react in one of seven ways: Front Gear Up, 
+ *  Front Gear Down, Rear Gear Up, Rear Gear Down, Shutdown, Switch Mode and
+ *  Hill Incoming.  Each tap of a gear button shifts one gear, holding it
+ *  shifts to the last gear that way.  The gear the rider settles in is 
+ *  learned for automatic mode.
  *  
  *  @par Parameters
  *				-@a automatic = a pointer used to denote the mode of
@@ -132,77 +169,91 @@ int main()
  */
 bool_t manual_mode(bool_t* automatic)
   {
-    uint8_t button = GetButtonState();
-    uint8_t release_check = button;
-    
-    while(release_check != BUTTONS_RELEASED && release_check != SHUTDOWN &&
-          release_check != HILL_NEARBY && release_check != SWITCH_MODE)
-      release_check = GetButtonState();
+    button_event event;
+    uint8_t button;
+    uint8_t gear;
     
+    if(GetButtonEvent(&event) == FALSE)
+      return TRUE;
+    button = event.buttons;
     
     if(button == FRONT_GEAR_UP && frontGear != 3)
     {
-      if(GetSpeed() == 0 || GetCadence() <= 24) 
+      if(GetSpeed() == 0 || GetCadence() <= FIX8_8(24)) 
       {
+        LedPlay(&ledLowCadence);
         warning = TRUE;
         return TRUE;
       }
       warning = FALSE;
-      LED_ON();
-      SetFrontGear(++frontGear);
-      LED_OFF();
+      gear = (event.type == BUTTON_HOLD) ? 3 : frontGear + 1;
+      if(SetFrontGear(gear) == TRUE)
+      {
+        frontGear = gear;
+        LearnShift();
+      }
       return TRUE;
     }
     if(button == FRONT_GEAR_DOWN && frontGear != 1)
     {
-      if(GetSpeed() == 0 || GetCadence() <= 24) 
+      if(GetSpeed() == 0 || GetCadence() <= FIX8_8(24)) 
        {
+        LedPlay(&ledLowCadence);
         warning = TRUE;
         return TRUE;
       }
       warning = FALSE;
-      LED_ON();
-      SetFrontGear(--frontGear);
-      LED_OFF();
+      gear = (event.type == BUTTON_HOLD) ? 1 : frontGear - 1;
+      if(SetFrontGear(gear) == TRUE)
+      {
+        frontGear = gear;
+        LearnShift();
+      }
       return TRUE;
     }
      if(button == REAR_GEAR_UP && rearGear != 7)
     {
-      if(GetSpeed() == 0 || GetCadence() <= 24) 
+      if(GetSpeed() == 0 || GetCadence() <= FIX8_8(24)) 
       {
+        LedPlay(&ledLowCadence);
         warning = TRUE;
         return TRUE;
       }
       warning = FALSE;
-      LED_ON();
-      SetRearGear(++rearGear);
-      LED_OFF();
+      gear = (event.type == BUTTON_HOLD) ? 7 : rearGear + 1;
+      if(SetRearGear(gear) == TRUE)
+      {
+        rearGear = gear;
+        LearnShift();
+      }
       return TRUE;
     }
     if(button == REAR_GEAR_DOWN && rearGear != 1)
     {
-      if(GetSpeed() == 0 || GetCadence() <= 24) 
+      if(GetSpeed() == 0 || GetCadence() <= FIX8_8(24)) 
       {
+        LedPlay(&ledLowCadence);
         warning = TRUE;
         return TRUE;
       }
       warning = FALSE;
-      LED_ON();
-      SetRearGear(--rearGear);
-      LED_OFF();
+      gear = (event.type == BUTTON_HOLD) ? 1 : rearGear - 1;
+      if(SetRearGear(gear) == TRUE)
+      {
+        rearGear = gear;
+        LearnShift();
+      }
       return TRUE;
     }
     if(button == SHUTDOWN)
     {
       pStats = POWERDOWN;
-      frontEE = frontGear;
-      rearEE = rearGear;
+      SaveGears();
       return FALSE;
     }
     if(button == SWITCH_MODE)
     {
       *automatic = TRUE;
-      while(GetButtonState() != BUTTONS_RELEASED);
       return TRUE;
     }
     if(button == HILL_NEARBY)
@@ -212,9 +263,8 @@ bool_t manual_mode(bool_t* automatic)
       else
         hill = FALSE;
     
-      if (hill == TRUE)
+      if (hill == TRUE && HillShift() == TRUE)
       {
-        HillShift();
         frontGear = 1;
         rearGear = 6;
         return TRUE;
@@ -223,10 +273,10 @@ bool_t manual_mode(bool_t* automatic)
     return TRUE;
   }
 
-/** A function for automatic mode control. This will react when a button 
- *  is input in one of three ways: Shutdown, Switch Mode and Hill Incoming.
- *  Once the function determines no buttons were pressed, it runs the 
- *  SingleAutoShift function to determine which gear the rider should be in.
+/** A function for automatic mode control. This will react to the next 
+ *  button event, if there is one, in one of three ways: Shutdown, Switch 
+ *  Mode and Hill Incoming.  Otherwise it runs the SingleAutoShift function
+ *  to determine which gear the rider should be in.
  *
  *  @par Parameters
  *				-@a automatic = a pointer used to denote the mode of
@@ -244,12 +294,11 @@ bool_t manual_mode(bool_t* automatic)
  */
 bool_t automatic_mode(bool_t* automatic)
 {
-  uint8_t button = GetButtonState();
-  uint8_t release_check = button;  
+  button_event event;
+  uint8_t button = BUTTONS_RELEASED;
   
-  while(release_check != BUTTONS_RELEASED && release_check != SHUTDOWN &&
-        release_check != HILL_NEARBY && release_check != SWITCH_MODE)
-      release_check = GetButtonState();
+  if(GetButtonEvent(&event) == TRUE)
+    button = event.buttons;
     
   if(button == HILL_NEARBY)
   {
@@ -258,26 +307,24 @@ bool_t automatic_mode(bool_t* automatic)
     else
       hill = FALSE;
     
-    if (hill == TRUE)
+    if (hill == TRUE && HillShift() == TRUE)
     {
-      HillShift();
       frontGear = 1;
       rearGear = 6;
+      autoShifting = TRUE;  /*no decision until the hill gear settled*/
+      TaskOnce(TASK_SETTLE, NULL, AUTO_SETTLE_MS);
       return TRUE;
     }
   }
   if(button == SHUTDOWN)
     {
       pStats = POWERDOWN;
-      frontEE = frontGear;
-      rearEE = rearGear;
+      SaveGears();
       return FALSE;
     }
   if(button == SWITCH_MODE)
    {
      *automatic = FALSE;
-     ticks = 0;
-     while(GetButtonState() != BUTTONS_RELEASED);
      return TRUE;
    }
   SingleAutoShift();
@@ -286,13 +333,13 @@ bool_t automatic_mode(bool_t* automatic)
 }
 
 /** The Autoshift function used to control our gearing in automatic mode. 
- *  Gets a tick value and compares this to the current Shift index value.
- *  If the ticks is larger, then the shift index will increment by one. If
- *  the ticks is lower, then the shift index will decrement by one. Once
- *  adjusted, the function will flash the LEDs to inform the rider and 
- *  shift into gear.  Then the code is delayed two seconds in order to 
- *  prevent rapid shifts along with decreasing the amount of shifts to
- *  save on power.
+ *  Gets the speed and asks TargetGear for the gear that puts the cadence in
+ *  the rider's band.  When that is not the current gear, the function will 
+ *  flash the LED to inform the rider and shift straight into it, however 
+ *  many gears away it is.  Then a two second one-shot task holds off the 
+ *  next decision in order to prevent rapid shifts along with decreasing the
+ *  amount of shifts to save on power.
+ *  On a climb the gear is held at or below the cap set by ClimbCheck.
  *
  * @param [Out] warning = Boolean used to relay to the app when the
  * 					   rider is pealing too slowly. 
@@ -302,54 +349,229 @@ bool_t automatic_mode(bool_t* automatic)
  */
 void SingleAutoShift()
 {
-  if(shiftFlag == TRUE)
+  SensorSnapshot sensors;
+  uint8_t gear;
+  uint8_t target;
+  
+  if(autoShifting == TRUE)
   {
-    if (ticks == 0)
-    {
-      shift_index = GetTireTicks();
-    }
-    ticks = GetTireTicks();
-    if(GetCadence() <= 48) 
+    if(GetShiftState() == SHIFT_RUNNING)
+      return;
+    autoShifting = FALSE;
+    TaskOnce(TASK_SETTLE, NULL, AUTO_SETTLE_MS);  /*settle after the shift*/
+  }
+  
+  if(ClimbCheck() == TRUE)
+    return;
+  if(TaskPending(TASK_SETTLE) == TRUE)
+    return;
+  
+  GetSensorSnapshot(&sensors);
+  if(sensors.shiftFlag == TRUE)
+  {
+    if(sensors.cadence <= FIX8_8(48)) 
       {
+        if(warning == FALSE)
+          LedPlay(&ledLowCadence);  /*only when the warning is new*/
         warning = TRUE;
         return;
       }
-    else 
+    warning = FALSE;
+    ClearShiftFlag(sensors.sequence);
+    
+    gear = GEAR(GetFrontGear(), GetRearGear());
+    target = TargetGear(sensors.speed, gear, climb_cap);
+    if(target != gear)
     {
-      warning = FALSE;
-      if (ticks > shift_index && shift_index <= 21)
-      {
-        shift_index += 1;
-        FlashLedOff();
-        AutomaticShift(front_gear_table[shift_index], rear_gear_table[shift_index]);
-      }
-      else if (ticks < shift_index && shift_index >= 5)
-      {
-        shift_index -= 1;
-        FlashLedOff();
-        AutomaticShift(front_gear_table[shift_index], rear_gear_table[shift_index]);
-      }
-      else 
-        shiftFlag = FALSE;
-    } 
-    prev_ticks = ticks;
-    __delay_cycles(32000000);
+      if(GearHarder(target, gear) == TRUE)
+        LedPlay(&ledShiftUp);
+      else
+        LedPlay(&ledShiftDown);
+      StartAutoShift(target);
+      return;
+    }
+    TaskOnce(TASK_SETTLE, NULL, AUTO_SETTLE_MS);
+  }
+}
+
+/** Starts an automatic shift straight into a gear.
+ *
+ *  @par Parameters
+ *				-@a gear = gear to shift into.
+ */
+void StartAutoShift(uint8_t gear)
+{
+  frontGear = GEAR_FRONT(gear);
+  rearGear = GEAR_REAR(gear);
+  AutomaticShift(frontGear, rearGear);
+  autoShifting = TRUE;
+}
+    
+/** A function used to shift ahead of a climb in automatic mode.  The road
+ *  gradient caps the gear: at INCLINE_CLIMB_GRADE to the climbing gear 
+ *  and at INCLINE_STEEP_GRADE to the hill gear.  Each cap is
+ *  only lifted once the gradient drops a band lower, so a climb that 
+ *  wavers around a threshold does not shift back and forth.  A gear harder
+ *  than the cap is shifted down straight away, before the rider slows down.
+ *
+ *	@returns
+ *			-Returns TRUE when a shift was started.
+ */
+bool_t ClimbCheck()
+{
+  fix8_8_t gradient = GetGradient();
+  
+  if(gradient >= SFIX8_8(INCLINE_STEEP_GRADE))
+    climb_cap = HILL_GEAR;
+  else if(gradient >= SFIX8_8(INCLINE_CLIMB_GRADE))
+  {
+    if(climb_cap != HILL_GEAR)
+      climb_cap = CLIMB_GEAR;
+  }
+  else if(gradient >= SFIX8_8(INCLINE_FLAT_GRADE))
+  {
+    if(climb_cap == HILL_GEAR)
+      climb_cap = CLIMB_GEAR;
+  }
+  else
+    climb_cap = NO_GEAR;
+  
+  if(climb_cap == NO_GEAR 
+     || GearHarder(GEAR(GetFrontGear(), GetRearGear()), climb_cap) == FALSE)
+    return FALSE;
+  
+  LedPlay(&ledShiftDown);
+  StartAutoShift(climb_cap);
+  return TRUE;
+}
+
+/** The sense task, runs the background work of the sensors: the MPU6050 
+ *  samples, the gradient filter and the TWI timeout.  It also parks the 
+ *  bike once it has not moved for PARK_MINUTES, after writing what is not
+ *  saved yet to EEprom a byte per pass, and runs a calibration the app 
+ *  asked for once the bike stands still.
+ */
+void SenseTask()
+{
+  MPUSamplePoll();
+  if(TaskPending(TASK_CALIBRATE) == FALSE)
+    InclinePoll();  /*the calibration takes the samples meanwhile*/
+  TWIPoll();
+  
+  if(GetShiftState() != SHIFT_RUNNING && TaskPending(TASK_CALIBRATE) == FALSE
+     && GetTireIdleSeconds() >= PARK_MINUTES*60 && FlushEEprom() == TRUE)
+    Park();
+  
+  if(calibrate == TRUE && GetSpeed() == 0)
+  {
+    calibrate = FALSE;
+    CalibrateIMU();
+  }
+}
+
+/** The button task, hands the button events to manual or automatic mode.
+ *  Between patterns the LED stays on in automatic mode and while a manual
+ *  shift runs.
+ */
+void ButtonTask()
+{
+  if(automatic == FALSE)
+  {
+    if(GetShiftState() == SHIFT_RUNNING)
+      LedSteady(LED_LEVELS);  /*LED stays on while a manual shift runs*/
+    else
+      LedSteady(0);
+    on = manual_mode(&automatic);
+  }
+  else
+  {
+    LedSteady(LED_LEVELS);
+    on = automatic_mode(&automatic);
   }
 }
+
+/** The learning task, takes the sample a while after a manual shift and 
+ *  writes what was learned to EEprom now and then.  A cadence band the app
+ *  set is written to EEprom from here as well.
+ */
+void LearnTask()
+{
+  GearingFlush();
+  LearnPoll((automatic == FALSE && GetShiftState() != SHIFT_RUNNING)
+            ? TRUE : FALSE);
+}
+
+/** A function used to store the gears in EEprom at shutdown.  A shift that
+ *  is still running is stopped after its current step, so the gears saved 
+ *  are the ones the derailleurs are really in.
+ *
+ *  @param [Out] FrontEE = EEprom storage of the front gear.
+ *	@param [Out] RearEE = EEprom storage of the rear gear.
+ */
+void SaveGears()
+{
+  ShiftAbort();
+  while(ShiftPoll() == SHIFT_RUNNING);
+  frontGear = GetFrontGear();
+  rearGear = GetRearGear();
+  frontEE = frontGear;
+  rearEE = rearGear;
+}
     
-/** A function used to flash the LED off and on twice, over the course of
- *  about 1.5 seconds.
+/** A function used to write the next EEprom byte of the settings and the
+ *  learning that are not saved yet, without waiting for EEprom.  Called 
+ *  every pass before shutting down or parking.
+ *
+ *	@returns
+ *			-Returns TRUE once everything is in EEprom.
+ */
+bool_t FlushEEprom()
+{
+  if(CalibrationFlush() == FALSE)
+    return FALSE;
+  if(GearingFlush() == FALSE)
+    return FALSE;
+  return LearnFlush();
+}
+    
+/** A function used to park the bike once the tire has not moved for 
+ *  PARK_MINUTES.  The gears are saved, the servo controller is held in 
+ *  reset and the MPU6050 is left watching for motion while the AtMega128
+ *  powers down.  When the bike is moved the MPU6050 wakes it, the servo
+ *  controller is restarted in the gears it was left in and sampling 
+ *  resumes.  The time from the INT4 edge to ready is kept in wakeLatency,
+ *  the oscillator start-up before the wake up interrupt can run is taken 
+ *  from PARK_STARTUP_US since no timer runs then.
+ *
+ *  @param [Out] wakeLatency = us from wake to ready, at most 65535.
  */
-void FlashLedOff()
+void Park()
 {
-  PORTE &= ~(1 << 7);
-  __delay_cycles(8000000);
-  PORTE |=  (1 << 7);
-  __delay_cycles(8000000);
-  PORTE &= ~(1 << 7);
-  __delay_cycles(8000000);
-  PORTE |=  (1 << 7);
+  uint32_t woke;
+  uint32_t took;
+  
+  SaveGears();
+  LedStop();  /*the tick stops while powered down*/
+  ParkServos();
+  MPUPark();
+  
+  woke = PowerDown();
   
+  MPUUnpark();
+  InitServos(frontGear, rearGear);
+  ClearTireIdle();
+  took = NowUs() - woke + PARK_STARTUP_US;
+  wakeLatency = (took > 0xFFFF) ? 0xFFFF : (uint16_t)took;
+}
+
+/** A function used to return the time the last wake from parking took
+ *
+ *	@returns
+ *			-Returns the wake to ready time in us
+ */
+uint16_t GetWakeLatency()
+{
+  return wakeLatency;
 }
 
 /** A function used to return our current warning state
@@ -362,6 +584,99 @@ uint8_t GetWarning()
   return (uint8_t)warning;
 }
 
+/** A function used to load the MPU6050 calibration from EEprom.  On the
+ *  first boot there is none yet, so the MPU6050 is calibrated in the 
+ *  background and the result is stored.  The bike has to stand still on
+ *  level ground then.
+ */
+void LoadCalibration()
+{
+  MPU_calibration cal = imuEE;
+  
+  if(cal.valid == MPU_CAL_VALID)
+    MPUSetCalibration(&cal);
+  else
+    CalibrateIMU();
+}
+
+/** A function used to start a calibration of the MPU6050.  CalibrateTask 
+ *  runs it and the LED flashes dimly meanwhile.  A calibration that is 
+ *  already running carries on.
+ */
+void CalibrateIMU()
+{
+  if(TaskPending(TASK_CALIBRATE) == TRUE)
+    return;
+  MPUCalibrateStart();
+  LedPlay(&ledCalibrating);
+  TaskPeriodic(TASK_CALIBRATE, CalibrateTask, SENSE_MS);
+}
+
+/** The calibration task, takes the MPU6050 samples until the calibration 
+ *  is over and then writes the result to EEprom a byte per run.  Nothing is
+ *  stored when the calibration failed, e.g. because the bike moved, and 
+ *  the old calibration stays in use.
+ *
+ *  @param [Out] imuCal = calibration to store.
+ */
+void CalibrateTask()
+{
+  MPU_calibration cal;
+  mpu_cal_t result;
+  
+  if(calUnsaved == FALSE)
+  {
+    result = MPUCalibratePoll(&cal);
+    if(result == MPU_CAL_RUNNING)
+      return;
+    LedStop();
+    if(result == MPU_CAL_FAILED)
+    {
+      TaskCancel(TASK_CALIBRATE);
+      return;
+    }
+    imuCal = cal;
+    calUnsaved = TRUE;
+    calCleared = FALSE;
+  }
+  if(CalibrationFlush() == TRUE)
+    TaskCancel(TASK_CALIBRATE);
+}
+
+/** A function used to write the next EEprom byte of a new calibration, 
+ *  without waiting for EEprom.  The valid mark is cleared first and set 
+ *  last, so a save cut short leaves no half written calibration in use.
+ *
+ *	@returns
+ *			-Returns TRUE once EEprom holds the calibration.
+ */
+bool_t CalibrationFlush()
+{
+  static uint8_t const notValid = 0;
+  
+  if(calUnsaved == FALSE)
+    return TRUE;
+  if(calCleared == FALSE)
+  {
+    if(EEpromSync(&imuEE.valid, &notValid, 1) == FALSE)
+      return FALSE;
+    calCleared = TRUE;
+  }
+  if(EEpromSync((uint8_t __eeprom*)&imuEE, (uint8_t const*)&imuCal,
+                sizeof(imuCal)) == FALSE)
+    return FALSE;
+  calUnsaved = FALSE;
+  return TRUE;
+}
+
+/** A function used by the app to ask for a new MPU6050 calibration.  It is
+ *  run from the main loop the next time the bike is standing still.
+ */
+void RequestCalibration()
+{
+  calibrate = TRUE;
+}
+
 /** A function used to return our current power state
  *
  *	@returns
@@ -0,0 +1,92 @@
+/**
+ * @file   power.c  <br>
+ * @brief  Sleep control source file  <br>
+ * @defgroup power Power
+ * @{
+ *
+ * This source file puts the CPU in idle sleep between the interrupts that
+ * hand work to the main loop, and measures how long it slept.  A parked
+ * bike powers down until it is moved.
+ *
+ */
+ 
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "power.h"
+#include "timebase.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define SLEEP_MODE_MASK  ((1<<SM0)|(1<<SM1)|(1<<SM2))  /* all 0 is idle */
+#define SLEEP_POWER_DOWN (1<<SM1)
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+volatile uint8_t wakePending = 1;  /* run the main loop once at start up */
+volatile uint8_t parkWake = 0;     /* set by the interrupt that ends parking */
+volatile uint32_t parkWakeUs;      /* NowUs() when that interrupt ran         */
+uint32_t asleepUs = 0;             /* us asleep since the report              */
+uint32_t reportStamp = 0;          /* NowUs() of the last report              */
+
+/*----------------------------------------------------------------------------*/
+/* FUNCTIONS                                                                  */
+/*----------------------------------------------------------------------------*/
+void IdleSleep(void)
+{
+  uint32_t start = NowUs();
+  
+  /* The flag is checked with interrupts off and SEI always runs the next 
+     instruction first, so an interrupt can't slip in between the check and
+     the sleep and leave us waiting for the next one. */
+  __disable_interrupt();
+  while(wakePending == 0)
+  {
+    MCUCR = (MCUCR & ~SLEEP_MODE_MASK) | (1<<SE);
+    __enable_interrupt();
+    __sleep();
+    __disable_interrupt();
+  }
+  MCUCR &= ~(1<<SE);
+  wakePending = 0;
+  __enable_interrupt();
+  
+  asleepUs += NowUs() - start;
+}
+
+uint32_t PowerDown(void)
+{
+  uint32_t woke;
+  
+  __disable_interrupt();
+  while(parkWake == 0)
+  {
+    MCUCR = (MCUCR & ~SLEEP_MODE_MASK) | SLEEP_POWER_DOWN | (1<<SE);
+    __enable_interrupt();
+    __sleep();
+    __disable_interrupt();
+  }
+  MCUCR &= ~(SLEEP_MODE_MASK | (1<<SE));
+  parkWake = 0;
+  woke = parkWakeUs;
+  __enable_interrupt();
+  return woke;
+}
+
+uint8_t GetAwakePercent(void)
+{
+  uint32_t now = NowUs();
+  uint32_t total = now - reportStamp;
+  uint32_t asleep = asleepUs;
+  
+  reportStamp = now;
+  asleepUs = 0;
+  if(total < 100)
+    return 0;
+  asleep /= total / 100;
+  return (asleep >= 100) ? 0 : (uint8_t)(100 - asleep);
+}
+
+/** @} */ /* power */
@@ -0,0 +1,78 @@
+/**
+ * @file   power.h  <br>
+ * @brief  Header file for the sleep control. <br>
+ * @defgroup power Power
+ * @{
+ *
+ * This header file contains the function prototypes used to put the 
+ * AtMega128 to sleep while there is nothing to do.
+ *
+ * The main loop sleeps in idle mode until an interrupt hands it work.  Idle
+ * is the deepest mode that keeps Timer0, Timer1, Timer2, Timer3, the TWI and
+ * both USARTs running on the system clock, power-save would stop them.
+ * Interrupts that have work for the main loop call WAKE_MAIN(), every other
+ * interrupt is served and the CPU goes straight back to sleep.
+ *
+ * A parked bike powers down instead.  That stops the system clock and every
+ * timer with it, only an external interrupt on a low level (INT7:4), an 
+ * edge on INT3:0, a TWI address match or a reset wake the AtMega128.
+ *
+ */
+ 
+/* Used to prevent multiple inclusion of the header file */
+#ifndef POWER_H
+#define POWER_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+/** Called from an interrupt that has work for the main loop */
+#define WAKE_MAIN()  (wakePending = 1)
+
+/** Called from the interrupt that wakes a parked bike, notes when it ran.
+ *  Needs timebase.h.
+ */
+#define WAKE_FROM_PARK()  (parkWakeUs = NowUs(), parkWake = 1)
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+extern volatile uint8_t wakePending;
+extern volatile uint8_t parkWake;
+extern volatile uint32_t parkWakeUs;
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Puts the CPU in idle sleep until an interrupt calls WAKE_MAIN(), returns 
+ *  straight away if one already has since the last call.  The scheduler 
+ *  tick calls it when the next task is due.
+ */
+void IdleSleep(void);
+
+/** Powers the CPU down until an interrupt calls WAKE_FROM_PARK().  The wake
+ *  source has to be armed before the call, other interrupts that fire in 
+ *  the meantime are served and the CPU powers down again.  Time spent 
+ *  powered down is not counted by NowUs().
+ *
+ *	@returns
+ *			-Returns NowUs() when the wake up interrupt ran, the first time
+ *			 the CPU could note after the oscillator started.
+ */
+uint32_t PowerDown(void);
+
+/** Returns the share of time the CPU was awake, measured since the last 
+ *  call.  The time spent in interrupts while asleep counts as asleep.
+ *
+ *  @returns
+ *			- returns the awake time in percent.
+ */
+uint8_t GetAwakePercent(void);
+
+#endif /* POWER_H */
+/** @} */ /* power */
@@ -0,0 +1,190 @@
+/**
+ * @file   scheduler.c  <br>
+ * @brief  Task scheduler source file  <br>
+ * @defgroup scheduler Scheduler
+ * @{
+ *
+ * This source file runs the tasks of the main loop when they are due and
+ * keeps the time each one takes.  Due times are kept in system ticks, a
+ * 16 bit count that wraps after about 2 minutes, so they are compared as
+ * signed differences and no task can be further than 65 seconds out.
+ * The tick also notes the time it was counted at, so how late a task
+ * started is measured in us from the tick it was due at, including the
+ * wait for the tasks ahead of it in the same pass.
+ *
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "scheduler.h"
+#include "timebase.h"
+#include "power.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define TICK_US      (TICK_MS * 1000UL)
+#define DUE(t, now)  ((int16_t)((t) - (now)) <= 0)
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+typedef struct
+{
+  void (*run)(void);
+  uint16_t period;    /* ticks between runs, 0 for a one-shot */
+  uint16_t due;       /* tick of the next run                 */
+  bool_t   active;    /* FALSE once stopped or a one-shot ran */
+  task_stats stats;
+} task;
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+task tasks[TASK_COUNT];
+volatile uint16_t tickCount = 0;  /* system ticks, only the tick moves it  */
+volatile uint16_t nextDue = 0;    /* tick the main loop is woken at        */
+volatile uint32_t tickUs = 0;     /* NowUs() the last tick was counted at  */
+
+/*----------------------------------------------------------------------------*/
+/* FUNCTIONS                                                                  */
+/*----------------------------------------------------------------------------*/
+void InitScheduler(void)
+{
+  uint8_t i;
+
+  for(i = 0; i < TASK_COUNT; ++i)
+    tasks[i].active = FALSE;
+}
+
+void SchedulerTick(void)
+{
+  tickUs = NowUs();
+  if(++tickCount == nextDue)
+    WAKE_MAIN();
+}
+
+static __monitor uint16_t Ticks(void)
+{
+  return tickCount;
+}
+
+/* Returns the tick count and the time it was counted at */
+static __monitor uint16_t TickTime(uint32_t* us)
+{
+  *us = tickUs;
+  return tickCount;
+}
+
+/* Moves the wake up to due if that is sooner than the one set */
+static __monitor void WakeAt(uint16_t due)
+{
+  uint16_t now = tickCount;
+
+  if(DUE(due, now))
+    WAKE_MAIN();
+  else if(DUE(nextDue, now) || (int16_t)(due - nextDue) < 0)
+    nextDue = due;
+}
+
+static void TaskStart(task_id_t id, void (*run)(void), uint16_t period,
+                      uint16_t delay)
+{
+  task* t = &tasks[id];
+
+  t->run = run;
+  t->period = period;
+  t->due = Ticks() + delay;
+  t->active = TRUE;
+  WakeAt(t->due);
+}
+
+void TaskPeriodic(task_id_t id, void (*run)(void), uint16_t periodMs)
+{
+  uint16_t period = periodMs / TICK_MS;
+
+  if(period == 0)
+    period = 1;
+  TaskStart(id, run, period, period);
+}
+
+void TaskOnce(task_id_t id, void (*run)(void), uint16_t delayMs)
+{
+  TaskStart(id, run, 0, delayMs / TICK_MS);
+}
+
+void TaskCancel(task_id_t id)
+{
+  tasks[id].active = FALSE;
+}
+
+bool_t TaskPending(task_id_t id)
+{
+  return tasks[id].active;
+}
+
+/* Runs one task and adds the run to its accounting.  nowUs is the time
+   tick now was counted at, the task was due whole ticks before that. */
+static void TaskRun(task* t, uint16_t now, uint32_t nowUs)
+{
+  uint32_t start = NowUs();
+  uint32_t late = (start - nowUs)
+                  + (uint32_t)(uint16_t)(now - t->due) * TICK_US;
+  uint32_t took;
+
+  if(t->period == 0)
+    t->active = FALSE;
+  else
+  {
+    t->due += t->period;
+    if(DUE(t->due, now))
+      t->due = now + t->period;  /* skip the runs it missed */
+  }
+
+  if(t->run != NULL)
+    t->run();
+  took = NowUs() - start;
+
+  t->stats.busy += took;
+  t->stats.runs++;
+  if(took > t->stats.worst)
+    t->stats.worst = (took > 0xFFFF) ? 0xFFFF : (uint16_t)took;
+  if(late > t->stats.late)
+    t->stats.late = (late > 0xFFFF) ? 0xFFFF : (uint16_t)late;
+}
+
+void SchedulerRun(void)
+{
+  uint32_t nowUs;
+  uint16_t now = TickTime(&nowUs);
+  uint16_t next = now + 0x7FFF;
+  uint8_t i;
+
+  for(i = 0; i < TASK_COUNT; ++i)
+  {
+    if(tasks[i].active == TRUE && DUE(tasks[i].due, now))
+      TaskRun(&tasks[i], now, nowUs);
+  }
+
+  /* the tasks may have started or stopped others, so look again */
+  for(i = 0; i < TASK_COUNT; ++i)
+  {
+    if(tasks[i].active == TRUE && (int16_t)(tasks[i].due - next) < 0)
+      next = tasks[i].due;
+  }
+  WakeAt(next);
+}
+
+void GetTaskStats(task_id_t id, task_stats* stats)
+{
+  task_stats* s = &tasks[id].stats;
+
+  *stats = *s;
+  s->busy = 0;
+  s->worst = 0;
+  s->late = 0;
+  s->runs = 0;
+}
+
+/** @} */ /* scheduler */
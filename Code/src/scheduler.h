@@ -0,0 +1,124 @@
+/**
+ * @file   scheduler.h  <br>
+ * @brief  Header file for the task scheduler. <br>
+ * @defgroup scheduler Scheduler
+ * @{
+ *
+ * This header file contains the function prototypes of a small cooperative
+ * scheduler.  Every task runs to completion from the main loop, none of
+ * them may wait, so a task that is due only ever waits for the tasks ahead
+ * of it in the same pass.
+ *
+ * The system tick is the 2ms button polling interrupt on Timer0.  It wakes
+ * the main loop when the next task is due.  Tasks are either periodic or
+ * one-shot, and the time each one runs and how late it started is kept
+ * for the app.
+ *
+ */
+
+/* Used to prevent multiple inclusion of the header file */
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include <stddef.h>
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define TICK_MS  2  /* system tick, Timer0 */
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+/** The tasks, due tasks run in this order */
+typedef enum
+{
+  TASK_SHIFT = 0,   /* servo steps and settle polling, while shifting */
+  TASK_SENSE,       /* MPU6050 samples, gradient filter, TWI       */
+  TASK_CALIBRATE,   /* MPU6050 calibration and its EEprom writes   */
+  TASK_BUTTONS,     /* button events, manual and automatic mode    */
+  TASK_SETTLE,      /* one-shot, end of the wait after an auto shift */
+  TASK_LEARN,       /* gear learning samples and EEprom writes     */
+  TASK_TELEMETRY,   /* Bluetooth commands and telemetry            */
+  TASK_COUNT
+} task_id_t;
+
+/** Run time accounting of one task, in us.  worst and late stop at 65535 */
+typedef struct
+{
+  uint32_t busy;    /* time spent running since the last read      */
+  uint16_t worst;   /* longest single run                          */
+  uint16_t late;    /* longest time from due to started            */
+  uint16_t runs;    /* runs since the last read                    */
+} task_stats;
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Stops every task, has to be called before any task is started */
+void InitScheduler(void);
+
+/** Advances the system tick, called from the Timer0 interrupt every
+ *  TICK_MS.  Wakes the main loop when the next task is due.
+ */
+void SchedulerTick(void);
+
+/** Starts a task that runs every period, the first time one period from
+ *  now.  Replaces whatever the task was doing before.
+ *
+ *  @par Parameters
+ *				-@a id = task to start.
+ *				-@a run = function to run, may not wait.
+ *				-@a periodMs = time between runs, rounded down to ticks but
+ *				               at least one tick.
+ */
+void TaskPeriodic(task_id_t id, void (*run)(void), uint16_t periodMs);
+
+/** Starts a task that runs once after delay.  Calling it again before it
+ *  ran moves the run to the new delay.  Without a function the task only
+ *  times the delay, TaskPending() reports TRUE until it is over.
+ *
+ *  @par Parameters
+ *				-@a id = task to start.
+ *				-@a run = function to run, may not wait, or NULL.
+ *				-@a delayMs = time until it runs, 0 for the next pass.
+ */
+void TaskOnce(task_id_t id, void (*run)(void), uint16_t delayMs);
+
+/** Stops a task, it does not run again until it is started again.
+ *
+ *  @par Parameters
+ *				-@a id = task to stop.
+ */
+void TaskCancel(task_id_t id);
+
+/** A function used to check whether a task is still going to run.
+ *
+ *  @par Parameters
+ *				-@a id = task to check.
+ *
+ *	@returns
+ *			-Returns TRUE for a periodic task and for a one-shot that has
+ *			 not run yet.
+ */
+bool_t TaskPending(task_id_t id);
+
+/** Runs every task that is due once, in task_id_t order.  Called from the
+ *  main loop after it wakes up.
+ */
+void SchedulerRun(void);
+
+/** Copies the run time accounting of a task and starts it over.
+ *
+ *  @par Parameters
+ *				-@a id = task to read.
+ *				-@a stats = filled in with the accounting.
+ */
+void GetTaskStats(task_id_t id, task_stats* stats);
+
+#endif /* SCHEDULER_H */
+/** @} */ /* scheduler */
@@ -18,19 +18,58 @@
 #include <ina90.h>
 #include "uart.h"
 #include "servos.h"
+#include "shift_table.h"
+#include "power.h"
+#include "scheduler.h"
+#include "timebase.h"
 
 /*----------------------------------------------------------------------------*/
 /* MACROS                                                                     */
 /*----------------------------------------------------------------------------*/
-#define UP   TRUE
-#define DOWN FALSE
 #define FRONT_SERVO_OFF()    PORTA &= ~(1 << 0);
 #define FRONT_SERVO_ON()     PORTA |= (1 << 0); __delay_cycles(100);
 #define REAR_SERVO_OFF()     PORTA &= ~(1 << 1);
 #define REAR_SERVO_ON()      PORTA |= (1 << 1); __delay_cycles(100);
 
+#define SET_TARGET           0x84  /* Maestro compact protocol commands */
+#define SET_MULTIPLE_TARGETS 0x9F
+#define SET_SPEED            0x87
+#define GET_POSITION         0x90
+#define GET_MOVING_STATE     0x93
+#define SERVO_POLL_INTERVAL  10    /* ms between moving state queries  */
+#define SERVO_REPLY_TIMEOUT  5     /* ms to wait for a Maestro reply   */
+#define SHIFT_PLAN_SIZE      32    /* queued moves, power of 2         */
+#define REAR_STEP_WAIT       500   /* ms for the rear derailleur       */
+#define FRONT_STEP_WAIT      1500  /* ms for the front derailleur      */
+#define PREP_PAUSE           62    /* ms between rear prep and front   */
 
+/* Servo move codes queued by the planners and stored in shift_table.h.  The 
+   targets are looked up from the gears the derailleurs are in when the move
+   is sent.  A trim follows each front move, using the opposite direction's 
+   rear table to put the chain back onto the rear gear it jumped off. */
+#define MOVE_END             0     /* end of a shift_table.h path       */
+#define MOVE_REAR_UP         1
+#define MOVE_REAR_DOWN       2
+#define MOVE_FRONT_UP        3
+#define MOVE_FRONT_DOWN      4
+#define MOVE_TRIM_UP         5     /* rear trim after MOVE_FRONT_UP     */
+#define MOVE_TRIM_DOWN       6     /* rear trim after MOVE_FRONT_DOWN   */
+#define MOVE_PAUSE           7
 
+#define SHIFT_STATE(front, rear) (((front)-1)*7 + ((rear)-1))
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+/* How far the running step is in finding out the servos have arrived */
+typedef enum
+{
+  SETTLE_OFF,          /* pause step, only the wait counts            */
+  SETTLE_IDLE,         /* waiting to send the next moving state query */
+  SETTLE_MOVING_STATE, /* waiting for the Get Moving State reply      */
+  SETTLE_POSITION,     /* waiting for a Get Position reply            */
+  SETTLE_MARGIN        /* arrived, waiting out the settle margin      */
+} settle_t;
 
 /*----------------------------------------------------------------------------*/
 /* Global Data                                                                */
@@ -63,6 +102,30 @@ uint16_t rear_gears_down[3][7] =/*1*/ {{4*1625,4*1575,4*1535,4*1495,4*1448,4*139
 uint8_t current_rear_gear;
 uint8_t current_front_gear;
 
+uint8_t plan[SHIFT_PLAN_SIZE];    /* circular queue of moves to run     */
+uint8_t planHead = 0;             /* index of the move running or next  */
+uint8_t planCount = 0;            /* moves queued, including running    */
+uint8_t planFront;                /* front gear after the last queued move */
+uint8_t planRear;                 /* rear gear after the last queued move  */
+uint8_t stepsDone = 0;            /* moves finished since the shift began  */
+uint8_t stepMoves = 0;            /* moves sent in the running step, or 0  */
+bool_t  abortShift = FALSE;       /* drop the queue after this move        */
+shift_state_t shiftState = SHIFT_IDLE;
+
+volatile uint16_t servoWait = 0;       /* ms left, counted by Timer2 */
+volatile bool_t servoWaitDone = TRUE;  /* set once servoWait hits 0  */
+volatile uint8_t servoTicks = 0;       /* ms counted while waiting   */
+
+servo_move stepBatch[2];          /* targets sent by the running step      */
+uint8_t  stepCount = 0;           /* targets in stepBatch                  */
+uint16_t stepMargin = 0;          /* settle margin of the running step     */
+settle_t settle = SETTLE_OFF;
+uint8_t  settleTime;              /* servoTicks when settle last changed   */
+uint8_t  settleIndex;             /* stepBatch entry being checked         */
+uint8_t  reply[2];                /* Maestro reply bytes                   */
+uint8_t  replyBytes;              /* reply bytes received so far           */
+uint32_t commandStamp = 0;        /* NowUs() when targets were last sent   */
+
 /*----------------------------------------------------------------------------*/
 /* FUNCTIONS                                                                  */
 /*----------------------------------------------------------------------------*/
@@ -70,137 +133,456 @@ uint8_t current_front_gear;
 extern float getCadence();
 extern float getSpeed();
 
+/* Starts the step wait.  Timer2 only interrupts while a wait is running.*/
+static __monitor void StartWait(uint16_t ms)
+{
+  servoWait = ms;
+  if(ms == 0)
+  {
+    servoWaitDone = TRUE;
+    return;
+  }
+  servoWaitDone = FALSE;
+  TCNT2 = 0;
+  TIFR = (1<<OCF2);  /* write 1 to clear, |= would clear OCF1A too */
+  TIMSK |= (1<<OCIE2);
+}
 
-void InitServos(uint8_t front, uint8_t rear)
+/* Timer2 compare match every 1ms while a step is waiting */
+#pragma vector= TIMER2_COMP_vect
+__interrupt void ISR_COMP2()
 {
-  current_front_gear = front;
-  current_rear_gear = rear;
+  servoTicks++;
+  WAKE_MAIN();  /* settle polling runs every tick */
+  if(--servoWait == 0)
+  {
+    servoWaitDone = TRUE;
+    TIMSK &= ~(1<<OCIE2);
+  }
+}
 
-  SERVO_RESET_DDR  |= (1<<SERVO_RESET_PIN);
-  SERVO_RESET_PORT &= ~(1<<SERVO_RESET_PIN);
-  __delay_cycles(5000);
-  SERVO_RESET_PORT |= (1<<SERVO_RESET_PIN);
-  
-  InitUART(SERVO_CONTROLLER, UBRR_SERVOS);
-  DDRA = 0x03;
-  FRONT_SERVO_OFF();
-  REAR_SERVO_OFF();
+/* Sets the speed limit the servo controller ramps a channel's pulse with */
+static void SetSpeed(servoChannel_t channel, uint16_t speed)
+{
+  TransmitUART(SERVO_CONTROLLER, SET_SPEED);
+  TransmitUART(SERVO_CONTROLLER, channel);
+  TransmitUART(SERVO_CONTROLLER, (uint8_t) (speed & 0x7F));    /* LSB */
+  TransmitUART(SERVO_CONTROLLER, (uint8_t) (speed>>7) & 0x7F); /* MSB */
 }
 
-void SetRearGear(uint8_t gear)
+/* Appends a move to the plan, the caller checks there is room */
+static void PlanMove(uint8_t move)
 {
-  while(gear != current_rear_gear)
-  {
-    uint16_t* gear_ptr;
-    REAR_SERVO_ON();
+  plan[(planHead + planCount) & (SHIFT_PLAN_SIZE - 1)] = move;
+  planCount++;
+}
+
+/* Returns move i of a packed shift_table.h path */
+static uint8_t PathMove(uint8_t __flash const* path, uint8_t i)
+{
+  uint8_t codes = path[i >> 1];
+  return (i & 1) ? (codes >> 4) : (codes & 0x0F);
+}
+
+/* Runs the shift state machine every tick while a shift runs */
+static void ShiftTask(void)
+{
+  if(ShiftPoll() != SHIFT_RUNNING)
+    TaskCancel(TASK_SHIFT);
+}
+
+/* Queues a shift.  Automatic shifts copy their path out of shift_table.h.  
+   Manual shifts move the front or the rear straight to the requested gear,
+   one gear at a time, without going through the prep gears.  A shift that
+   does not fit is dropped completely. */
+static bool_t QueuePlan(uint8_t front, uint8_t rear, bool_t automatic)
+{
+  uint8_t i;
   
-    if((gear - current_rear_gear) > 0)
-    {
-      gear_ptr = rear_gears_up[current_front_gear-1];
-    }
-    else if((gear - current_rear_gear) < 0)
+  if(front < 1 || front > 3 || rear < 1 || rear > 7)
+    return FALSE;
+  
+  if(automatic == TRUE)
+  {
+    uint8_t __flash const* path = 
+      shift_paths[SHIFT_STATE(planFront, planRear)][SHIFT_STATE(front, rear)];
+    uint8_t moves = 0;
+    
+    while(moves < SHIFT_PATH_MOVES && PathMove(path, moves) != MOVE_END)
+      moves++;
+    if(moves > SHIFT_PLAN_SIZE - planCount)
+      return FALSE;
+    for(i = 0; i < moves; ++i)
+      PlanMove(PathMove(path, i));
+  }
+  else if(front != planFront)
+  {
+    uint8_t steps = (front > planFront) ? front - planFront : planFront - front;
+    
+    if(2*steps > SHIFT_PLAN_SIZE - planCount)
+      return FALSE;
+    for(i = 0; i < steps; ++i)
     {
-      gear_ptr = rear_gears_down[current_front_gear-1];
-      current_rear_gear = current_rear_gear - 2;
+      PlanMove((front > planFront) ? MOVE_FRONT_UP : MOVE_FRONT_DOWN);
+      PlanMove((front > planFront) ? MOVE_TRIM_UP : MOVE_TRIM_DOWN);
     }
-    TransmitUART(SERVO_CONTROLLER, 0x84);
-    TransmitUART(SERVO_CONTROLLER, REAR_SERVO_CHANNEL);
-    TransmitUART(SERVO_CONTROLLER, (uint8_t) (gear_ptr[current_rear_gear] & 0x7F));    /* LSB */
-    TransmitUART(SERVO_CONTROLLER, (uint8_t) (gear_ptr[current_rear_gear]>>7) & 0x7F); /* MSB */
-    current_rear_gear++;
-    __delay_cycles(8000000);
+  }
+  else
+  {
+    uint8_t steps = (rear > planRear) ? rear - planRear : planRear - rear;
     
+    if(steps > SHIFT_PLAN_SIZE - planCount)
+      return FALSE;
+    for(i = 0; i < steps; ++i)
+      PlanMove((rear > planRear) ? MOVE_REAR_UP : MOVE_REAR_DOWN);
+  }
+  planFront = front;
+  planRear = rear;
+  
+  if(shiftState != SHIFT_RUNNING && planCount != 0)
+  {
+    stepsDone = 0;
+    abortShift = FALSE;
+    shiftState = SHIFT_RUNNING;
+    TaskPeriodic(TASK_SHIFT, ShiftTask, TICK_MS);
+  }
+  return TRUE;
+}
+
+/* Returns the servo target of a move made from the given gears */
+static uint16_t MoveTarget(uint8_t move, uint8_t front, uint8_t rear)
+{
+  switch(move)
+  {
+  case MOVE_REAR_UP:    return rear_gears_up[front-1][rear];
+  case MOVE_REAR_DOWN:  return rear_gears_down[front-1][rear-2];
+  case MOVE_FRONT_UP:   return front_gears_up[rear-1][front];
+  case MOVE_FRONT_DOWN: return front_gears_down[rear-1][front-2];
+  case MOVE_TRIM_UP:    return rear_gears_down[front-1][rear-1];
+  case MOVE_TRIM_DOWN:  return rear_gears_up[front-1][rear-1];
   }
+  return 0;
+}
+
+/* Sends a step's targets and starts its wait.  The wait is the worst case 
+   time for the step, PollSettle() ends it early once the servos arrive. */
+static void SendStep(uint8_t count, uint16_t wait, uint16_t margin)
+{
+  ServoMoveBatch(stepBatch, count);
+  stepCount = count;
+  stepMargin = margin;
+  settle = SETTLE_IDLE;
+  settleTime = servoTicks;
+  StartWait(wait);
 }
 
-void SetFrontGear(uint8_t gear)
+/* Sends the move at the head of the plan from the gears the derailleurs are
+   in now, then starts its wait.  A front move and the trim queued behind it
+   go out together in one batch.  Returns the number of moves sent. */
+static uint8_t StartMove()
 {
-  while(gear != current_front_gear)
+  uint8_t front = current_front_gear;
+  uint8_t rear = current_rear_gear;
+  uint8_t move = plan[planHead];
+  uint8_t next = plan[(planHead + 1) & (SHIFT_PLAN_SIZE - 1)];
+  
+  if(move == MOVE_PAUSE)
   {
+    settle = SETTLE_OFF;
+    StartWait(PREP_PAUSE);
+    return 1;
+  }
+  
+  if(move == MOVE_FRONT_UP || move == MOVE_FRONT_DOWN)
+  {
+    stepBatch[0].channel = FRONT_SERVO_CHANNEL;
+    stepBatch[0].target = MoveTarget(move, front, rear);
     FRONT_SERVO_ON();
-    uint16_t* gear_ptr;
-    bool_t direction;
     
-    if((gear - current_front_gear) > 0)
+    if(planCount > 1 && next == move + (MOVE_TRIM_UP - MOVE_FRONT_UP))
     {
-      gear_ptr = front_gears_up[current_rear_gear-1];
-      direction = UP;
+      front = (move == MOVE_FRONT_UP) ? front + 1 : front - 1;
+      stepBatch[1].channel = REAR_SERVO_CHANNEL;
+      stepBatch[1].target = MoveTarget(next, front, rear);
+      REAR_SERVO_ON();
+      SendStep(2, FRONT_STEP_WAIT, SERVO_FRONT_SETTLE_MS);
+      return 2;
     }
-    else if((gear - current_front_gear) < 0)
+    SendStep(1, FRONT_STEP_WAIT, SERVO_FRONT_SETTLE_MS);
+    return 1;
+  }
+  
+  stepBatch[0].channel = REAR_SERVO_CHANNEL;
+  stepBatch[0].target = MoveTarget(move, front, rear);
+  REAR_SERVO_ON();
+  SendStep(1, REAR_STEP_WAIT, SERVO_REAR_SETTLE_MS);
+  return 1;
+}
+
+/* Asks the servo controller whether the running step has arrived, without
+   ever blocking on a reply.  Get Moving State has to report nothing moving
+   and Get Position has to match every target of the step, then the wait is
+   cut short to the step's settle margin so the derailleur can come to rest.
+   Replies that don't come back in time just mean another query later, the
+   step's worst case wait still ends it. */
+static void PollSettle()
+{
+  uint8_t now = servoTicks;
+  uint8_t expected = (settle == SETTLE_POSITION) ? 2 : 1;
+  
+  switch(settle)
+  {
+  case SETTLE_IDLE:
+    if((uint8_t)(now - settleTime) < SERVO_POLL_INTERVAL)
+      return;
+    while(UARTReceiveReady(SERVO_CONTROLLER) == TRUE)
+      ReceiveUART(SERVO_CONTROLLER);  /* drop late replies */
+    TransmitUART(SERVO_CONTROLLER, GET_MOVING_STATE);
+    settle = SETTLE_MOVING_STATE;
+    settleTime = now;
+    replyBytes = 0;
+    return;
+    
+  case SETTLE_MOVING_STATE:
+  case SETTLE_POSITION:
+    while(replyBytes < expected && UARTReceiveReady(SERVO_CONTROLLER) == TRUE)
+      reply[replyBytes++] = ReceiveUART(SERVO_CONTROLLER);
+    if(replyBytes < expected)
+    {
+      if((uint8_t)(now - settleTime) >= SERVO_REPLY_TIMEOUT)
+      {
+        settle = SETTLE_IDLE;
+        settleTime = now;
+      }
+      return;
+    }
+    
+    if(settle == SETTLE_MOVING_STATE)
+    {
+      settleIndex = 0;
+      if(reply[0] != 0)
+      {
+        settle = SETTLE_IDLE;
+        settleTime = now;
+        return;
+      }
+    }
+    else
     {
-      gear_ptr = front_gears_down[current_rear_gear-1];
-      current_front_gear = current_front_gear - 2;
-      direction = DOWN;
+      if(((((uint16_t)reply[1])<<8) | reply[0]) != stepBatch[settleIndex].target)
+      {
+        settle = SETTLE_IDLE;
+        settleTime = now;
+        return;
+      }
+      settleIndex++;
     }
-    TransmitUART(SERVO_CONTROLLER, 0x84);
-    TransmitUART(SERVO_CONTROLLER, FRONT_SERVO_CHANNEL);
-    TransmitUART(SERVO_CONTROLLER, (uint8_t) (gear_ptr [current_front_gear] & 0x7F));    /* LSB */
-    TransmitUART(SERVO_CONTROLLER, (uint8_t) (gear_ptr [current_front_gear]>>7) & 0x7F); /* MSB */
+    
+    if(settleIndex == stepCount)
+    {
+      settle = SETTLE_MARGIN;
+      StartWait(stepMargin);
+      return;
+    }
+    TransmitUART(SERVO_CONTROLLER, GET_POSITION);
+    TransmitUART(SERVO_CONTROLLER, stepBatch[settleIndex].channel);
+    settle = SETTLE_POSITION;
+    settleTime = now;
+    replyBytes = 0;
+    return;
+    
+  default:
+    return;
+  }
+}
+
+/* Moves the gears along once a move's wait is over.  The front servo is
+   only powered while it moves. */
+static void FinishMove(uint8_t move)
+{
+  switch(move)
+  {
+  case MOVE_REAR_UP:
+    current_rear_gear++;
+    break;
+    
+  case MOVE_REAR_DOWN:
+    current_rear_gear--;
+    break;
+    
+  case MOVE_FRONT_UP:
+    FRONT_SERVO_OFF();
     current_front_gear++;
-    __delay_cycles(24000000);
+    break;
+    
+  case MOVE_FRONT_DOWN:
     FRONT_SERVO_OFF();
+    current_front_gear--;
+    break;
+  }
+}
+
+void ServoMoveBatch(servo_move const* moves, uint8_t count)
+{
+  uint8_t i;
+  bool_t contiguous = (SERVO_MULTI_TARGET && count > 1) ? TRUE : FALSE;
   
-    if(direction == DOWN)
-    {
-      gear_ptr = rear_gears_up[current_front_gear-1];
-    }
-    else if(direction == UP)
+  commandStamp = NowUs();
+  for(i = 1; i < count && contiguous == TRUE; ++i)
+  {
+    if(moves[i].channel != moves[0].channel + i)
+      contiguous = FALSE;
+  }
+  
+  if(contiguous == TRUE)
+  {
+    TransmitUART(SERVO_CONTROLLER, SET_MULTIPLE_TARGETS);
+    TransmitUART(SERVO_CONTROLLER, count);
+    TransmitUART(SERVO_CONTROLLER, moves[0].channel);
+    for(i = 0; i < count; ++i)
     {
-      gear_ptr = rear_gears_down[current_front_gear-1];
+      TransmitUART(SERVO_CONTROLLER, (uint8_t) (moves[i].target & 0x7F));    /* LSB */
+      TransmitUART(SERVO_CONTROLLER, (uint8_t) (moves[i].target>>7) & 0x7F); /* MSB */
     }
-    TransmitUART(SERVO_CONTROLLER, 0x84);
-    TransmitUART(SERVO_CONTROLLER, REAR_SERVO_CHANNEL);
-    TransmitUART(SERVO_CONTROLLER, (uint8_t) (gear_ptr[current_rear_gear-1] & 0x7F));    /* LSB */
-    TransmitUART(SERVO_CONTROLLER, (uint8_t) (gear_ptr[current_rear_gear-1]>>7) & 0x7F); /* MSB */
-    __delay_cycles(8000000);
+    return;
+  }
+  
+  for(i = 0; i < count; ++i)
+  {
+    TransmitUART(SERVO_CONTROLLER, SET_TARGET);
+    TransmitUART(SERVO_CONTROLLER, moves[i].channel);
+    TransmitUART(SERVO_CONTROLLER, (uint8_t) (moves[i].target & 0x7F));    /* LSB */
+    TransmitUART(SERVO_CONTROLLER, (uint8_t) (moves[i].target>>7) & 0x7F); /* MSB */
   }
 }
 
-void killServos()
+void InitServos(uint8_t front, uint8_t rear)
 {
-  REAR_SERVO_OFF();
+  current_front_gear = front;
+  current_rear_gear = rear;
+  planFront = front;
+  planRear = rear;
+
+  SERVO_RESET_DDR  |= (1<<SERVO_RESET_PIN);
+  SERVO_RESET_PORT &= ~(1<<SERVO_RESET_PIN);
+  __delay_cycles(5000);
+  SERVO_RESET_PORT |= (1<<SERVO_RESET_PIN);
+  
+  InitUART(SERVO_CONTROLLER, UBRR_SERVOS);
+  DDRA = 0x03;
   FRONT_SERVO_OFF();
+  REAR_SERVO_OFF();
+  
+  SetSpeed(FRONT_SERVO_CHANNEL, SERVO_FRONT_SPEED);
+  SetSpeed(REAR_SERVO_CHANNEL, SERVO_REAR_SPEED);
+  
+  TCCR2 = (1<<WGM21)               /* CTC mode */
+        | (1<<CS21) | (1<<CS20);   /* prescalar of 64 */
+  OCR2 = 249;                      /* count up to 1ms */
+  __enable_interrupt();
 }
 
-void HillShift()
+bool_t ShiftRequest(uint8_t front, uint8_t rear)
+{
+  return QueuePlan(front, rear, TRUE);
+}
+
+bool_t SetRearGear(uint8_t gear)
+{
+  return QueuePlan(planFront, gear, FALSE);
+}
+
+bool_t SetFrontGear(uint8_t gear)
+{
+  return QueuePlan(gear, planRear, FALSE);
+}
+
+void AutomaticShift(uint8_t front_gear, uint8_t rear_gear)
 {
-  for (int i = current_front_gear; i != 0; --i)//shift depending on front position
+  ShiftRequest(front_gear, rear_gear);
+}
+
+bool_t HillShift()
+{
+  return ShiftRequest(1, 6);
+}
+
+shift_state_t ShiftPoll()
+{
+  if(shiftState != SHIFT_RUNNING)
+    return shiftState;
+  if(servoWaitDone != TRUE)
   {
-    if (current_front_gear == 3 && i == 2)// shift into 3 (rear prep gear) if were in 3 in the front
-      SetRearGear(3);
-    else if (current_front_gear == 2 && i == 1)// shift into 5 (rear prep gear) if were in 2 in the front
-      SetRearGear(5);
-    SetFrontGear(i);// shift the front down after we're in the correct prep gear
+    PollSettle();
+    return shiftState;
   }
-  SetRearGear(6);// shift into 6 to complete hill climb gear
+  
+  while(stepMoves != 0)
+  {
+    FinishMove(plan[planHead]);
+    planHead = (planHead + 1) & (SHIFT_PLAN_SIZE - 1);
+    planCount--;
+    stepsDone++;
+    stepMoves--;
+  }
+  
+  if(abortShift == TRUE)
+  {
+    planCount = 0;
+    planFront = current_front_gear;
+    planRear = current_rear_gear;
+    shiftState = SHIFT_ABORTED;
+    return shiftState;
+  }
+  if(planCount == 0)
+  {
+    shiftState = SHIFT_DONE;
+    return shiftState;
+  }
+  
+  stepMoves = StartMove();
+  return shiftState;
 }
 
-void AutomaticShift(uint8_t front_gear, uint8_t rear_gear)
+void ShiftAbort()
 {
-  int j;
-   if((front_gear - current_front_gear) > 0)
-    {
-      j = 1;
-    }
-    else if((front_gear - current_front_gear) < 0)
-    {
-      j = -1;
-    }
-   
-  for (int i = current_front_gear; i != front_gear; i= i + j)//shift depending on front position
-  {
-    if (current_front_gear == 1 && j == 1)// shift into 3 (rear prep gear) if we're in 1 in the front
-      SetRearGear(5);
-    else if (current_front_gear == 2 && j == 1)// shift into 3 (rear prep gear) if we're in 2 in the front
-      SetRearGear(3);
-    else if (current_front_gear == 3 && j == -1)// shift into 3 (rear prep gear) if we're in 3 in the front
-      SetRearGear(3);
-    else if (current_front_gear == 2 && j == -1)// shift into 5 (rear prep gear) if we're in 2 in the front
-      SetRearGear(5);
-    __delay_cycles(1000000);
-    SetFrontGear(i+j);// shift the front down after we're in the correct prep gear
-  }
-  SetRearGear(rear_gear);// shift into requested gear
+  if(shiftState == SHIFT_RUNNING)
+    abortShift = TRUE;
+}
+
+shift_state_t GetShiftState()
+{
+  return shiftState;
+}
+
+void GetShiftStatus(shift_status* status)
+{
+  status->state = shiftState;
+  status->stepsDone = stepsDone;
+  status->stepsLeft = planCount;
+  status->commandStamp = commandStamp;
+}
+
+uint8_t GetFrontGear()
+{
+  return current_front_gear;
+}
+
+uint8_t GetRearGear()
+{
+  return current_rear_gear;
+}
+
+void killServos()
+{
+  REAR_SERVO_OFF();
+  FRONT_SERVO_OFF();
+}
+
+void ParkServos()
+{
+  killServos();
+  SERVO_RESET_PORT &= ~(1<<SERVO_RESET_PIN);
 }
 
 /** @} */ /* servos */
\ No newline at end of file
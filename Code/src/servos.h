@@ -15,6 +15,12 @@
  * & 2 (Rear).  The servo controller is connected to 5v, 6v battery voltage for 
  * the servos and to the UART pins on PORTE 0 (RX) & 1 (Reset).
  *
+ * Shifting does not block.  Each request is planned into a queue of servo
+ * steps and returns straight away.  Queueing a shift starts TASK_SHIFT, which
+ * calls ShiftPoll() every tick until the queue is done, it sends the next 
+ * step's targets once Timer2 has timed out the previous step's wait.  No
+ * task runs while the servos are idle.  Progress, completion and abort are 
+ * read back with GetShiftState() and GetShiftStatus().
  *
  *
  *
@@ -35,12 +41,35 @@
 /*----------------------------------------------------------------------------*/
 #include "common.h"
 
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+/** State of the shift queue.  DONE and ABORTED stay until the next request.*/
+typedef enum {SHIFT_IDLE, SHIFT_RUNNING, SHIFT_DONE, SHIFT_ABORTED} shift_state_t;
+
+/** One servo target for ServoMoveBatch(), in quarter-microseconds. */
+typedef struct
+{
+  servoChannel_t channel;
+  uint16_t target;
+} servo_move;
+
+/** Progress of the shift currently running or last run. */
+typedef struct
+{
+  shift_state_t state;
+  uint8_t stepsDone;   /* servo steps finished since the shift began */
+  uint8_t stepsLeft;   /* servo steps still queued, including the running one */
+  uint32_t commandStamp; /* NowUs() when servo targets were last sent   */
+} shift_status;
+
 /*----------------------------------------------------------------------------*/
 /* Prototypes                                                                 */
 /*----------------------------------------------------------------------------*/
 /** A function used to set the current_gear value to the one stored from EEprom
  *  along with resetting the servo controller and setting both servos off 
- *  initially.
+ *  initially.  Also sets timer/counter2 to CTC mode with a 1ms period, it is
+ *  used to time the servo steps.
  *
  * @par Parameters
  *				-@a front = front gear value to set current front gear to.
@@ -48,64 +77,80 @@
  */
 void InitServos(uint8_t front, uint8_t rear);
 
-/** A function which takes in a rear gear value and shifts to that value
- *  one gear at a time.  The function uses two different arrays, one for 
+/** A function which takes in a rear gear value and queues the shift to that
+ *  value one gear at a time.  The planner uses two different arrays, one for 
  *  up shifting and another for down shifting.  We decide our direction, 
- *  then chose the appropriate array and shift.
+ *  then chose the appropriate array.  Each step waits 0.5 seconds.
  *
  *	@par Parameters
  *  			-@a gear = Rear gear value to shift into.
- *  			
- */
-void SetRearGear(uint8_t gear);
-
-/** A function that takes the requested front gear value and shifts to it 
- *  one gear at a time.  This function also only engages the front servo for
- *  1.5 seconds and then cuts power once it is in gear to save power along 
- *  with allowing the dérailleur to trim itself instead of staying in a
- *  position that produces contact with the chain.  Once the front servo 
- *  shifts, the rear will readjust back into the gear it was in previously.  
- *  This readjustment was necessary due to the chain jumping gears when the
- *  front gear was shifted. It is minimized in rear gear 3 and 5 but still 
- *  occurs.  We use our direction to chose between two different arrays for
- *  the servo placement.  When readjusting the rear gears, the array direction
- *  is opposite of the front array's direction.
+ *
+ *  @returns
+ *			-TRUE if the shift was queued, FALSE if the gear is out of range
+ *			 or the queue is full.
+ */
+bool_t SetRearGear(uint8_t gear);
+
+/** A function that takes the requested front gear value and queues the shift
+ *  to it one gear at a time.  The front servo is only powered for the 1.5
+ *  seconds of each step and then cut to save power along with allowing the
+ *  dérailleur to trim itself instead of staying in a position that produces
+ *  contact with the chain.  Along with the front servo, the rear will 
+ *  readjust back into the gear it was in previously.  This readjustment was
+ *  necessary due to the chain jumping gears when the front gear was shifted.
+ *  It is minimized in rear gear 3 and 5 but still occurs.  We use our 
+ *  direction to chose between two different arrays for the servo placement. 
+ *  When readjusting the rear gears, the array direction is opposite of the 
+ *  front array's direction.
  *  
  * @par Parameters
  *  			-@a gear = Front gear value to shift into.
+ *
+ * @returns
+ *			-TRUE if the shift was queued, FALSE if the gear is out of range
+ *			 or the queue is full.
+ */
+bool_t SetFrontGear(uint8_t gear);
+
+/** Sends a batch of servo targets that should move together.  When the 
+ *  channels are consecutive and SERVO_MULTI_TARGET is set, the batch goes
+ *  out as one Set Multiple Targets (0x9F) packet, otherwise as one Set 
+ *  Target (0x84) packet per servo.  Used by the shift state machine, so 
+ *  each front move of AutomaticShift and HillShift is sent together with
+ *  its rear trim.
+ *
+ * @par Parameters
+ *				-@a moves = channels, in ascending order, and their targets.
+ *				-@a count = number of moves in the batch.
  */
-void SetFrontGear(uint8_t gear);
+void ServoMoveBatch(servo_move const* moves, uint8_t count);
 
 /** A function used to immediately disable both rear and front servos by setting
  *  the low side driver MOSFET's gate to 0. 
  */
 void killServos();
 
-/** A function used to automatically change the gearing from its current
- *  position into gear one in the front and six in the rear.  
+/** A function used to park the servos: both are cut like killServos() and 
+ *  the servo controller is held in reset.  InitServos() brings it back.
+ */
+void ParkServos();
+
+/** A function used to queue a shift from any gear into gear one in the front 
+ *  and six in the rear.  Same as ShiftRequest(1, 6).
  *
- *	This function is meant to be able to shift into our hill climb gearing
- *  from any gear.  Also it will only shift the front once our gears in the
- *  rear are in the proper transition gears.  
  *  i.e.
  *  Shifting from 3,1 (front, rear) to our hill climb gear, this is worst case.
  *	Shift in the rear from 1 to 3, then shift the front gear down into 2 (2,3).
  *	Shift in the rear from 3 to 5, then shift the front gear down into 1 (1,5).
  *  Lastly shift the rear from 5 into 6 completing the motion.
+ *
+ * @returns
+ *			-TRUE if the shift was queued, FALSE if the queue is full.
  */
-void HillShift();
+bool_t HillShift();
 
-/** A function used for general shifting in the front and rear.
- *  Based off the function used for HillShift, except this is multi-directional
- *  and allows for input of gears to shift to. 
- *
- *  As stated before, this function works the same way as HillShift above, the 
- *  front gear will only shift once the rear is in either 3 (if shifting between
- *  2 and 3 in the front) or 5 (if shifting in-between 1 and 2 in the front).  
- *  After the front shift, the rear will make its way one gear at a time to its
- *  final destination.  In this functions use, the front gear doesn't move more 
- *  than one gear at a time, but it contains protections in case it were to 
- *  happen.
+/** A function used for general shifting in the front and rear, same as 
+ *  ShiftRequest(front_gear, rear_gear).
  *
  * @par Parameters
  *  			-@a front_gear = front gear value to shift into.
@@ -113,5 +158,67 @@ void HillShift();
  */
 void AutomaticShift(uint8_t front_gear, uint8_t rear_gear);
 
+/** Queues a shift in the front and rear and returns immediately.  The front 
+ *  gear will only shift once the rear is in either 3 (if shifting between 2 
+ *  and 3 in the front) or 5 (if shifting in-between 1 and 2 in the front).
+ *  After the front shift, the rear will make its way one gear at a time to
+ *  its final destination.  The moves are copied from the path in 
+ *  shift_table.h, generated by tools/gen_shift_table.py.  A request made 
+ *  while a shift is running is planned from where the running shift ends and
+ *  queued behind it.
+ *
+ * @par Parameters
+ *  			-@a front = front gear value to shift into.
+ *				-@a rear = rear gear value to shift into.
+ *
+ * @returns
+ *			-TRUE if the shift was queued, FALSE if a gear is out of range or
+ *			 the queue is full.
+ */
+bool_t ShiftRequest(uint8_t front, uint8_t rear);
+
+/** Runs the shift state machine, TASK_SHIFT calls it while a shift runs.  Starts
+ *  the next queued step once the previous step's wait has run out.  While a
+ *  step runs it polls the servo controller's moving state and positions, and
+ *  ends the step early, after a settle margin, once the servos have arrived.
+ *
+ * @returns
+ *			-Returns the state of the shift queue.
+ */
+shift_state_t ShiftPoll();
+
+/** Stops a running shift once the step that is moving has finished.  The 
+ *  rest of the queue is dropped and ShiftPoll() reports SHIFT_ABORTED.
+ */
+void ShiftAbort();
+
+/** Returns the state of the shift queue, without running it.
+ *
+ * @returns
+ *			-Returns SHIFT_RUNNING until the queued shifts are done.
+ */
+shift_state_t GetShiftState();
+
+/** Copies the state and progress of the shift queue into status.
+ *
+ * @par Parameters
+ *				-@a status = structure to copy the progress into.
+ */
+void GetShiftStatus(shift_status* status);
+
+/** Returns the front gear the derailleur is in, the last finished step.
+ *
+ * @returns
+ *			-Returns the current front gear.
+ */
+uint8_t GetFrontGear();
+
+/** Returns the rear gear the derailleur is in, the last finished step.
+ *
+ * @returns
+ *			-Returns the current rear gear.
+ */
+uint8_t GetRearGear();
+
 #endif /* SERVOS_H */
 /** @} */ /* servos */
\ No newline at end of file
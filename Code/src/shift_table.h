@@ -0,0 +1,529 @@
+/**
+ * @file   shift_table.h  <br>
+ * @brief  Generated shift paths, do not edit. <br>
+ * @defgroup servos Servos
+ * @{
+ *
+ * Generated by tools/gen_shift_table.py.  Holds the quickest legal
+ * sequence of servo moves from every (front, rear) gear to every other.
+ * Indexed by [from][to] with a state of (front-1)*7 + (rear-1).  Two
+ * move codes are packed per byte, low nibble first, ending at MOVE_END.
+ */
+
+#ifndef SHIFT_TABLE_H
+#define SHIFT_TABLE_H
+
+#define SHIFT_STATES      21
+#define SHIFT_PATH_BYTES  9
+#define SHIFT_PATH_MOVES  16 /* longest path */
+
+static __flash const uint8_t shift_paths[SHIFT_STATES][SHIFT_STATES][SHIFT_PATH_BYTES] =
+{
+  /* from 1,1 */
+  {
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x11,0x11,0x37,0x25,0x22,0x02,0x00,0x00,0x00}, /* to 2,1 */
+    {0x11,0x11,0x37,0x25,0x22,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x11,0x11,0x37,0x25,0x02,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x11,0x11,0x37,0x25,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x11,0x11,0x37,0x05,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x11,0x37,0x15,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x11,0x37,0x15,0x01,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x11,0x11,0x37,0x25,0x72,0x53,0x22,0x00,0x00}, /* to 3,1 */
+    {0x11,0x11,0x37,0x25,0x72,0x53,0x02,0x00,0x00}, /* to 3,2 */
+    {0x11,0x11,0x37,0x25,0x72,0x53,0x00,0x00,0x00}, /* to 3,3 */
+    {0x11,0x11,0x37,0x25,0x72,0x53,0x01,0x00,0x00}, /* to 3,4 */
+    {0x11,0x11,0x37,0x25,0x72,0x53,0x11,0x00,0x00}, /* to 3,5 */
+    {0x11,0x11,0x37,0x25,0x72,0x53,0x11,0x01,0x00}, /* to 3,6 */
+    {0x11,0x11,0x37,0x25,0x72,0x53,0x11,0x11,0x00} /* to 3,7 */
+  },
+  /* from 1,2 */
+  {
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x11,0x71,0x53,0x22,0x22,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x11,0x71,0x53,0x22,0x02,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x11,0x71,0x53,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x11,0x71,0x53,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x11,0x71,0x53,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x71,0x53,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x71,0x53,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x11,0x71,0x53,0x22,0x37,0x25,0x02,0x00,0x00}, /* to 3,1 */
+    {0x11,0x71,0x53,0x22,0x37,0x25,0x00,0x00,0x00}, /* to 3,2 */
+    {0x11,0x71,0x53,0x22,0x37,0x05,0x00,0x00,0x00}, /* to 3,3 */
+    {0x11,0x71,0x53,0x22,0x37,0x15,0x00,0x00,0x00}, /* to 3,4 */
+    {0x11,0x71,0x53,0x22,0x37,0x15,0x01,0x00,0x00}, /* to 3,5 */
+    {0x11,0x71,0x53,0x22,0x37,0x15,0x11,0x00,0x00}, /* to 3,6 */
+    {0x11,0x71,0x53,0x22,0x37,0x15,0x11,0x01,0x00} /* to 3,7 */
+  },
+  /* from 1,3 */
+  {
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x11,0x37,0x25,0x22,0x02,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x11,0x37,0x25,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x11,0x37,0x25,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x11,0x37,0x25,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x11,0x37,0x05,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x37,0x15,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x37,0x15,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x11,0x37,0x25,0x72,0x53,0x22,0x00,0x00,0x00}, /* to 3,1 */
+    {0x11,0x37,0x25,0x72,0x53,0x02,0x00,0x00,0x00}, /* to 3,2 */
+    {0x11,0x37,0x25,0x72,0x53,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x11,0x37,0x25,0x72,0x53,0x01,0x00,0x00,0x00}, /* to 3,4 */
+    {0x11,0x37,0x25,0x72,0x53,0x11,0x00,0x00,0x00}, /* to 3,5 */
+    {0x11,0x37,0x25,0x72,0x53,0x11,0x01,0x00,0x00}, /* to 3,6 */
+    {0x11,0x37,0x25,0x72,0x53,0x11,0x11,0x00,0x00} /* to 3,7 */
+  },
+  /* from 1,4 */
+  {
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x71,0x53,0x22,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x71,0x53,0x22,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x71,0x53,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x71,0x53,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x71,0x53,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x71,0x53,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x71,0x53,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x71,0x53,0x22,0x37,0x25,0x02,0x00,0x00,0x00}, /* to 3,1 */
+    {0x71,0x53,0x22,0x37,0x25,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x71,0x53,0x22,0x37,0x05,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x71,0x53,0x22,0x37,0x15,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x71,0x53,0x22,0x37,0x15,0x01,0x00,0x00,0x00}, /* to 3,5 */
+    {0x71,0x53,0x22,0x37,0x15,0x11,0x00,0x00,0x00}, /* to 3,6 */
+    {0x71,0x53,0x22,0x37,0x15,0x11,0x01,0x00,0x00} /* to 3,7 */
+  },
+  /* from 1,5 */
+  {
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x37,0x25,0x22,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x37,0x25,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x37,0x25,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x37,0x25,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x37,0x05,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x37,0x15,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x37,0x15,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x37,0x25,0x72,0x53,0x22,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x37,0x25,0x72,0x53,0x02,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x37,0x25,0x72,0x53,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x37,0x25,0x72,0x53,0x01,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x37,0x25,0x72,0x53,0x11,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x37,0x25,0x72,0x53,0x11,0x01,0x00,0x00,0x00}, /* to 3,6 */
+    {0x37,0x25,0x72,0x53,0x11,0x11,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 1,6 */
+  {
+    {0x22,0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x72,0x53,0x22,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x72,0x53,0x22,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x72,0x53,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x72,0x53,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x72,0x53,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x72,0x53,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x72,0x53,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x72,0x53,0x22,0x37,0x25,0x02,0x00,0x00,0x00}, /* to 3,1 */
+    {0x72,0x53,0x22,0x37,0x25,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x72,0x53,0x22,0x37,0x05,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x72,0x53,0x22,0x37,0x15,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x72,0x53,0x22,0x37,0x15,0x01,0x00,0x00,0x00}, /* to 3,5 */
+    {0x72,0x53,0x22,0x37,0x15,0x11,0x00,0x00,0x00}, /* to 3,6 */
+    {0x72,0x53,0x22,0x37,0x15,0x11,0x01,0x00,0x00} /* to 3,7 */
+  },
+  /* from 1,7 */
+  {
+    {0x22,0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x22,0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x22,0x37,0x25,0x22,0x02,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x37,0x25,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x22,0x37,0x25,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x22,0x37,0x25,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x22,0x37,0x05,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x22,0x37,0x15,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x22,0x37,0x15,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x37,0x25,0x72,0x53,0x22,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x37,0x25,0x72,0x53,0x02,0x00,0x00,0x00}, /* to 3,2 */
+    {0x22,0x37,0x25,0x72,0x53,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x22,0x37,0x25,0x72,0x53,0x01,0x00,0x00,0x00}, /* to 3,4 */
+    {0x22,0x37,0x25,0x72,0x53,0x11,0x00,0x00,0x00}, /* to 3,5 */
+    {0x22,0x37,0x25,0x72,0x53,0x11,0x01,0x00,0x00}, /* to 3,6 */
+    {0x22,0x37,0x25,0x72,0x53,0x11,0x11,0x00,0x00} /* to 3,7 */
+  },
+  /* from 2,1 */
+  {
+    {0x11,0x11,0x47,0x26,0x22,0x02,0x00,0x00,0x00}, /* to 1,1 */
+    {0x11,0x11,0x47,0x26,0x22,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x11,0x11,0x47,0x26,0x02,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x11,0x11,0x47,0x26,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x11,0x11,0x47,0x06,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x11,0x47,0x16,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x11,0x47,0x16,0x01,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x11,0x37,0x25,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x11,0x37,0x25,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x11,0x37,0x05,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x11,0x37,0x15,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x11,0x37,0x15,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x11,0x37,0x15,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x11,0x37,0x15,0x11,0x01,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 2,2 */
+  {
+    {0x11,0x71,0x64,0x22,0x22,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x11,0x71,0x64,0x22,0x02,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x11,0x71,0x64,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x11,0x71,0x64,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x11,0x71,0x64,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x71,0x64,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x71,0x64,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x71,0x53,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x71,0x53,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x71,0x53,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x71,0x53,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x71,0x53,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x71,0x53,0x11,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x71,0x53,0x11,0x11,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 2,3 */
+  {
+    {0x11,0x47,0x26,0x22,0x02,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x11,0x47,0x26,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x11,0x47,0x26,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x11,0x47,0x26,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x11,0x47,0x06,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x47,0x16,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x47,0x16,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x37,0x25,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x37,0x25,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x37,0x05,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x37,0x15,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x37,0x15,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x37,0x15,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x37,0x15,0x11,0x01,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 2,4 */
+  {
+    {0x71,0x64,0x22,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x71,0x64,0x22,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x71,0x64,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x71,0x64,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x71,0x64,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x71,0x64,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x71,0x64,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x72,0x53,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x72,0x53,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x72,0x53,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x72,0x53,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x72,0x53,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x72,0x53,0x11,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x72,0x53,0x11,0x11,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 2,5 */
+  {
+    {0x47,0x26,0x22,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x47,0x26,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x47,0x26,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x47,0x26,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x47,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x47,0x16,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x47,0x16,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x37,0x25,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x37,0x25,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x22,0x37,0x05,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x22,0x37,0x15,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x22,0x37,0x15,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x22,0x37,0x15,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x22,0x37,0x15,0x11,0x01,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 2,6 */
+  {
+    {0x72,0x64,0x22,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x72,0x64,0x22,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x72,0x64,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x72,0x64,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x72,0x64,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x72,0x64,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x72,0x64,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x22,0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x72,0x53,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x72,0x53,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x22,0x72,0x53,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x22,0x72,0x53,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x22,0x72,0x53,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x22,0x72,0x53,0x11,0x01,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x22,0x72,0x53,0x11,0x11,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 2,7 */
+  {
+    {0x22,0x47,0x26,0x22,0x02,0x00,0x00,0x00,0x00}, /* to 1,1 */
+    {0x22,0x47,0x26,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 1,2 */
+    {0x22,0x47,0x26,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x22,0x47,0x26,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x22,0x47,0x06,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x22,0x47,0x16,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x22,0x47,0x16,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x22,0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x22,0x37,0x25,0x02,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x22,0x37,0x25,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x22,0x22,0x37,0x05,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x22,0x22,0x37,0x15,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x22,0x22,0x37,0x15,0x01,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x22,0x22,0x37,0x15,0x11,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x22,0x22,0x37,0x15,0x11,0x01,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 3,1 */
+  {
+    {0x11,0x47,0x16,0x71,0x64,0x22,0x22,0x00,0x00}, /* to 1,1 */
+    {0x11,0x47,0x16,0x71,0x64,0x22,0x02,0x00,0x00}, /* to 1,2 */
+    {0x11,0x47,0x16,0x71,0x64,0x22,0x00,0x00,0x00}, /* to 1,3 */
+    {0x11,0x47,0x16,0x71,0x64,0x02,0x00,0x00,0x00}, /* to 1,4 */
+    {0x11,0x47,0x16,0x71,0x64,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x11,0x47,0x16,0x71,0x64,0x01,0x00,0x00,0x00}, /* to 1,6 */
+    {0x11,0x47,0x16,0x71,0x64,0x11,0x00,0x00,0x00}, /* to 1,7 */
+    {0x11,0x47,0x26,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x11,0x47,0x26,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x11,0x47,0x06,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x11,0x47,0x16,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x11,0x47,0x16,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x11,0x47,0x16,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x11,0x47,0x16,0x11,0x01,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x11,0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x11,0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 3,2 */
+  {
+    {0x71,0x64,0x11,0x47,0x26,0x22,0x02,0x00,0x00}, /* to 1,1 */
+    {0x71,0x64,0x11,0x47,0x26,0x22,0x00,0x00,0x00}, /* to 1,2 */
+    {0x71,0x64,0x11,0x47,0x26,0x02,0x00,0x00,0x00}, /* to 1,3 */
+    {0x71,0x64,0x11,0x47,0x26,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x71,0x64,0x11,0x47,0x06,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x71,0x64,0x11,0x47,0x16,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x71,0x64,0x11,0x47,0x16,0x01,0x00,0x00,0x00}, /* to 1,7 */
+    {0x71,0x64,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x71,0x64,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x71,0x64,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x71,0x64,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x71,0x64,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x71,0x64,0x11,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x71,0x64,0x11,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x11,0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 3,3 */
+  {
+    {0x47,0x16,0x71,0x64,0x22,0x22,0x00,0x00,0x00}, /* to 1,1 */
+    {0x47,0x16,0x71,0x64,0x22,0x02,0x00,0x00,0x00}, /* to 1,2 */
+    {0x47,0x16,0x71,0x64,0x22,0x00,0x00,0x00,0x00}, /* to 1,3 */
+    {0x47,0x16,0x71,0x64,0x02,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x47,0x16,0x71,0x64,0x00,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x47,0x16,0x71,0x64,0x01,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x47,0x16,0x71,0x64,0x11,0x00,0x00,0x00,0x00}, /* to 1,7 */
+    {0x47,0x26,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x47,0x26,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x47,0x06,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x47,0x16,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x47,0x16,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x47,0x16,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x47,0x16,0x11,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x11,0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 3,4 */
+  {
+    {0x72,0x64,0x11,0x47,0x26,0x22,0x02,0x00,0x00}, /* to 1,1 */
+    {0x72,0x64,0x11,0x47,0x26,0x22,0x00,0x00,0x00}, /* to 1,2 */
+    {0x72,0x64,0x11,0x47,0x26,0x02,0x00,0x00,0x00}, /* to 1,3 */
+    {0x72,0x64,0x11,0x47,0x26,0x00,0x00,0x00,0x00}, /* to 1,4 */
+    {0x72,0x64,0x11,0x47,0x06,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x72,0x64,0x11,0x47,0x16,0x00,0x00,0x00,0x00}, /* to 1,6 */
+    {0x72,0x64,0x11,0x47,0x16,0x01,0x00,0x00,0x00}, /* to 1,7 */
+    {0x72,0x64,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x72,0x64,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x72,0x64,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x72,0x64,0x01,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x72,0x64,0x11,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x72,0x64,0x11,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x72,0x64,0x11,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x11,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 3,5 */
+  {
+    {0x22,0x47,0x16,0x71,0x64,0x22,0x22,0x00,0x00}, /* to 1,1 */
+    {0x22,0x47,0x16,0x71,0x64,0x22,0x02,0x00,0x00}, /* to 1,2 */
+    {0x22,0x47,0x16,0x71,0x64,0x22,0x00,0x00,0x00}, /* to 1,3 */
+    {0x22,0x47,0x16,0x71,0x64,0x02,0x00,0x00,0x00}, /* to 1,4 */
+    {0x22,0x47,0x16,0x71,0x64,0x00,0x00,0x00,0x00}, /* to 1,5 */
+    {0x22,0x47,0x16,0x71,0x64,0x01,0x00,0x00,0x00}, /* to 1,6 */
+    {0x22,0x47,0x16,0x71,0x64,0x11,0x00,0x00,0x00}, /* to 1,7 */
+    {0x22,0x47,0x26,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x47,0x26,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x22,0x47,0x06,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x22,0x47,0x16,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x22,0x47,0x16,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x22,0x47,0x16,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x22,0x47,0x16,0x11,0x01,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x11,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 3,6 */
+  {
+    {0x22,0x72,0x64,0x11,0x47,0x26,0x22,0x02,0x00}, /* to 1,1 */
+    {0x22,0x72,0x64,0x11,0x47,0x26,0x22,0x00,0x00}, /* to 1,2 */
+    {0x22,0x72,0x64,0x11,0x47,0x26,0x02,0x00,0x00}, /* to 1,3 */
+    {0x22,0x72,0x64,0x11,0x47,0x26,0x00,0x00,0x00}, /* to 1,4 */
+    {0x22,0x72,0x64,0x11,0x47,0x06,0x00,0x00,0x00}, /* to 1,5 */
+    {0x22,0x72,0x64,0x11,0x47,0x16,0x00,0x00,0x00}, /* to 1,6 */
+    {0x22,0x72,0x64,0x11,0x47,0x16,0x01,0x00,0x00}, /* to 1,7 */
+    {0x22,0x72,0x64,0x22,0x00,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x72,0x64,0x02,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x22,0x72,0x64,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x22,0x72,0x64,0x01,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x22,0x72,0x64,0x11,0x00,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x22,0x72,0x64,0x11,0x01,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x22,0x72,0x64,0x11,0x11,0x00,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  },
+  /* from 3,7 */
+  {
+    {0x22,0x22,0x47,0x16,0x71,0x64,0x22,0x22,0x00}, /* to 1,1 */
+    {0x22,0x22,0x47,0x16,0x71,0x64,0x22,0x02,0x00}, /* to 1,2 */
+    {0x22,0x22,0x47,0x16,0x71,0x64,0x22,0x00,0x00}, /* to 1,3 */
+    {0x22,0x22,0x47,0x16,0x71,0x64,0x02,0x00,0x00}, /* to 1,4 */
+    {0x22,0x22,0x47,0x16,0x71,0x64,0x00,0x00,0x00}, /* to 1,5 */
+    {0x22,0x22,0x47,0x16,0x71,0x64,0x01,0x00,0x00}, /* to 1,6 */
+    {0x22,0x22,0x47,0x16,0x71,0x64,0x11,0x00,0x00}, /* to 1,7 */
+    {0x22,0x22,0x47,0x26,0x02,0x00,0x00,0x00,0x00}, /* to 2,1 */
+    {0x22,0x22,0x47,0x26,0x00,0x00,0x00,0x00,0x00}, /* to 2,2 */
+    {0x22,0x22,0x47,0x06,0x00,0x00,0x00,0x00,0x00}, /* to 2,3 */
+    {0x22,0x22,0x47,0x16,0x00,0x00,0x00,0x00,0x00}, /* to 2,4 */
+    {0x22,0x22,0x47,0x16,0x01,0x00,0x00,0x00,0x00}, /* to 2,5 */
+    {0x22,0x22,0x47,0x16,0x11,0x00,0x00,0x00,0x00}, /* to 2,6 */
+    {0x22,0x22,0x47,0x16,0x11,0x01,0x00,0x00,0x00}, /* to 2,7 */
+    {0x22,0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,1 */
+    {0x22,0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,2 */
+    {0x22,0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,3 */
+    {0x22,0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,4 */
+    {0x22,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,5 */
+    {0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, /* to 3,6 */
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00} /* to 3,7 */
+  }
+};
+
+#endif /* SHIFT_TABLE_H */
+/** @} */ /* servos */
@@ -24,10 +24,18 @@
 
 #include "bluetooth.h"
 #include "button.h"
+#include "eeprom_sync.h"
+#include "gearing.h"
 #include "hall_effect.h"
 #include "i2c.h"
+#include "incline.h"
+#include "learn.h"
+#include "led.h"
 #include "MPU6050_control.h"
+#include "power.h"
+#include "scheduler.h"
 #include "servos.h"
+#include "timebase.h"
 #include "hall_effect.h"
 #include "uart.h"
 #include <math.h>
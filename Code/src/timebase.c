@@ -0,0 +1,96 @@
+/**
+ * @file   timebase.c  <br>
+ * @brief  System timebase source file  <br>
+ * @defgroup timebase Timebase
+ * @{
+ *
+ * This source file keeps the time since start up on Timer1.  Reading it
+ * takes one TCNT1 read and an add, the only care needed is a compare match
+ * that has cleared TCNT1 but whose interrupt has not run yet.
+ *
+ */
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "timebase.h"
+#include "hall_effect.h"
+
+/*----------------------------------------------------------------------------*/
+/* MACROS                                                                     */
+/*----------------------------------------------------------------------------*/
+#define TIMEBASE_TOP     62500U   /* Timer1 counts per second, 16us each   */
+#define TIMEBASE_US      1000000UL
+#define TIMEBASE_MS      1000UL
+
+/* Timer1 counts to ms, 16/1000 as a multiply and shift.  4194/2^18 is a
+   little under 0.016, so a window never reads more than 999ms. */
+#define COUNT_TO_MS      4194UL
+#define COUNT_TO_MS_SHIFT 18
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+volatile uint32_t usBase = 0;  /* time at the start of the current window */
+volatile uint32_t msBase = 0;
+
+/*----------------------------------------------------------------------------*/
+/* FUNCTIONS                                                                  */
+/*----------------------------------------------------------------------------*/
+void InitTimebase(void)
+{
+  OCR1A = TIMEBASE_TOP - 1; // Set time for 1 second
+
+  TIFR = (1<<OCF1A); // Timer/Counter1, Output Compare A Match Flag
+
+  TIMSK |= (1<<OCIE1A);  // Timer/Counter1, Output Compare A Match Interrupt Enable
+
+  TCCR1B |= ((1<<CS12) | (1<<WGM12)); // CTC mode and 256 pre-scaler
+
+  __enable_interrupt();
+}
+
+/* Returns the Timer1 count and whether a compare match that already
+   cleared it is still waiting for its interrupt.  Interrupts are off. */
+static uint16_t TimebaseCount(bool_t* wrapped)
+{
+  uint16_t count = TCNT1;
+
+  *wrapped = ((TIFR & (1<<OCF1A)) && count < (TIMEBASE_TOP/2)) ? TRUE : FALSE;
+  return count;
+}
+
+__monitor uint32_t NowUs(void)
+{
+  bool_t wrapped;
+  uint16_t count = TimebaseCount(&wrapped);
+  uint32_t base = usBase;
+
+  if(wrapped == TRUE)
+    base += TIMEBASE_US;
+  return base + ((uint32_t)count << 4);
+}
+
+__monitor uint32_t NowMs(void)
+{
+  bool_t wrapped;
+  uint16_t count = TimebaseCount(&wrapped);
+  uint32_t base = msBase;
+
+  if(wrapped == TRUE)
+    base += TIMEBASE_MS;
+  return base + ((count * COUNT_TO_MS) >> COUNT_TO_MS_SHIFT);
+}
+
+/* interrupt activated when the Timer/Counter 1 value reaches 62500 or 1
+   second.  Moves the time on by the second and ends the hall effect
+   window.*/
+#pragma vector= TIMER1_COMPA_vect
+__interrupt void ISR_COMP1A()
+{
+  usBase += TIMEBASE_US;
+  msBase += TIMEBASE_MS;
+  HallWindow();
+}
+
+/** @} */ /* timebase */
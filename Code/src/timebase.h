@@ -0,0 +1,55 @@
+/**
+ * @file   timebase.h  <br>
+ * @brief  Header file for the system timebase. <br>
+ * @defgroup timebase Timebase
+ * @{
+ *
+ * This header file contains the function prototypes used to read the time
+ * since start up.  Every driver stamps its data with it: hall edges, MPU6050
+ * samples, button events and servo commands.
+ *
+ * Timer1 counts in 16us steps and is cleared every second by its compare
+ * match, which also ends the hall effect measurement window.  The interrupt
+ * adds the second to a microsecond and a millisecond base, the time is the
+ * base plus the count.  Timer1 stops while the AtMega128 is powered down, so
+ * time spent parked is not counted.
+ *
+ */
+
+/* Used to prevent multiple inclusion of the header file */
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+/*----------------------------------------------------------------------------*/
+/* INCLUDES                                                                   */
+/*----------------------------------------------------------------------------*/
+#include "common.h"
+
+/*----------------------------------------------------------------------------*/
+/* Function Prototypes                                                        */
+/*----------------------------------------------------------------------------*/
+/** Sets all the proper bits to activate timer/counter 1 into
+ *		-CTC mode with a 256 prescaler.
+ *      -Top set to 62500 and will trigger an interrupt every 1 second.
+ */
+void InitTimebase(void);
+
+/** Returns the time since start up in microseconds, with 16us resolution.
+ *  Wraps after about 71 minutes, so only differences are meaningful.  Safe
+ *  to call from main and interrupts.
+ *
+ *  @returns
+ *			- returns the current time in us
+ */
+uint32_t NowUs(void);
+
+/** Returns the time since start up in milliseconds.  Wraps after about 49
+ *  days.  Safe to call from main and interrupts.
+ *
+ *  @returns
+ *			- returns the current time in ms
+ */
+uint32_t NowMs(void);
+
+#endif /* TIMEBASE_H */
+/** @} */ /* timebase */
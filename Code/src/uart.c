@@ -18,9 +18,95 @@
 /*----------------------------------------------------------------------------*/
 #include "uart.h"
 
+/*----------------------------------------------------------------------------*/
+/* Defines                                                                    */
+/*----------------------------------------------------------------------------*/
+#define SERVO_TX_SIZE      32  /* transmit ring sizes, powers of 2 */
+#define BLUETOOTH_TX_SIZE  64
+
+/*----------------------------------------------------------------------------*/
+/* Typedefs                                                                   */
+/*----------------------------------------------------------------------------*/
+/* Transmit ring of one USART.  The writer only moves head and the data 
+   register empty interrupt only moves tail, so neither needs a lock. */
+typedef struct
+{
+  uint8_t* buffer;
+  uint8_t  mask;           /* ring size - 1                         */
+  volatile uint8_t head;   /* next free slot                        */
+  volatile uint8_t tail;   /* next byte to send                     */
+  uint8_t  highWater;      /* most bytes ever waiting in the ring   */
+  volatile uint8_t sent;   /* 1 once a byte went out since the last flush */
+} uart_tx;
+
+/*----------------------------------------------------------------------------*/
+/* Global Data                                                                */
+/*----------------------------------------------------------------------------*/
+uint8_t servoTxBuffer[SERVO_TX_SIZE];
+uint8_t bluetoothTxBuffer[BLUETOOTH_TX_SIZE];
+uart_tx txRing[2] = {{servoTxBuffer, SERVO_TX_SIZE - 1, 0, 0, 0, 0},
+                     {bluetoothTxBuffer, BLUETOOTH_TX_SIZE - 1, 0, 0, 0, 0}};
+
 /*----------------------------------------------------------------------------*/
 /* Functions                                                                  */
 /*----------------------------------------------------------------------------*/
+/* Moves one byte from the ring into the data register.  Only called with
+   interrupts off and the data register empty.  Clears TXC so UartFlush can 
+   tell when the last byte has left the shift register. */
+static void SendNext(uart uart_device)
+{
+  uart_tx* ring = &txRing[uart_device];
+  
+  if(uart_device == SERVO_CONTROLLER)
+  {
+    UCSR0A = (UCSR0A & (1<<U2X0)) | (1<<TXC0);
+    UDR0 = ring->buffer[ring->tail];
+  }
+  else
+  {
+    UCSR1A = (UCSR1A & (1<<U2X1)) | (1<<TXC1);
+    UDR1 = ring->buffer[ring->tail];
+  }
+  ring->tail = (ring->tail + 1) & ring->mask;
+  ring->sent = 1;
+}
+
+/* Makes room in a full ring.  The interrupt does it on its own, but a 
+   writer running inside another interrupt, or with interrupts off, would 
+   wait forever for it, so the byte is sent by hand. */
+static __monitor void DrainOne(uart uart_device)
+{
+  uart_tx* ring = &txRing[uart_device];
+  uint8_t empty;
+  
+  if(uart_device == SERVO_CONTROLLER)
+    empty = UCSR0A & (1<<UDRE0);
+  else
+    empty = UCSR1A & (1<<UDRE1);
+  
+  if(empty && ring->head != ring->tail)
+    SendNext(uart_device);
+}
+
+/* data register empty interrupts, send the next byte or switch off */
+#pragma vector = USART0_UDRE_vect
+__interrupt void ISR_USART0_UDRE(void)
+{
+  if(txRing[SERVO_CONTROLLER].head != txRing[SERVO_CONTROLLER].tail)
+    SendNext(SERVO_CONTROLLER);
+  else
+    UCSR0B &= ~(1<<UDRIE0);
+}
+
+#pragma vector = USART1_UDRE_vect
+__interrupt void ISR_USART1_UDRE(void)
+{
+  if(txRing[BLUETOOTH_MODULE].head != txRing[BLUETOOTH_MODULE].tail)
+    SendNext(BLUETOOTH_MODULE);
+  else
+    UCSR1B &= ~(1<<UDRIE1);
+}
+
 void InitUART(uart uart_device, uint16_t ubrr)
 {
   if(uart_device == SERVO_CONTROLLER)
@@ -54,18 +140,65 @@ void InitUART(uart uart_device, uint16_t ubrr)
   }
 }
 
-void TransmitUART(uart uart_device, uint8_t data)
+uint8_t UartWrite(uart uart_device, uint8_t const* data, uint8_t length)
 {
-  if(uart_device == SERVO_CONTROLLER)
+  uart_tx* ring = &txRing[uart_device];
+  uint8_t head = ring->head;
+  uint8_t waiting;
+  uint8_t i;
+  
+  for(i = 0; i < length; ++i)
   {
-    UDR0 = data;
-    while(!(UCSR0A & (1<<UDRE0)));
-  }
-  else if(uart_device == BLUETOOTH_MODULE)
-  {
-    UDR1 = data;
-    while(!(UCSR1A & (1<<UDRE1)));
+    uint8_t next = (head + 1) & ring->mask;
+    if(next == ring->tail)
+      break;  /* full */
+    ring->buffer[head] = data[i];
+    head = next;
   }
+  ring->head = head;
+  
+  waiting = (head - ring->tail) & ring->mask;
+  if(waiting > ring->highWater)
+    ring->highWater = waiting;
+  
+  if(uart_device == SERVO_CONTROLLER)
+    UCSR0B |= (1<<UDRIE0);
+  else
+    UCSR1B |= (1<<UDRIE1);
+  return i;
+}
+
+void TransmitUART(uart uart_device, uint8_t data)
+{
+  while(UartWrite(uart_device, &data, 1) == 0)
+    DrainOne(uart_device);
+}
+
+void UartFlush(uart uart_device)
+{
+  uart_tx* ring = &txRing[uart_device];
+  
+  while(ring->head != ring->tail)
+    DrainOne(uart_device);
+  
+  if(ring->sent == 0)
+    return;  /* TXC is only meaningful once something was sent */
+  if(uart_device == SERVO_CONTROLLER)
+    while(!(UCSR0A & (1<<TXC0)));
+  else
+    while(!(UCSR1A & (1<<TXC1)));
+  ring->sent = 0;
+}
+
+uint8_t UartTxFree(uart uart_device)
+{
+  uart_tx* ring = &txRing[uart_device];
+  return ring->mask - ((ring->head - ring->tail) & ring->mask);
+}
+
+uint8_t UartHighWater(uart uart_device)
+{
+  return txRing[uart_device].highWater;
 }
 
 uint8_t ReceiveUART(uart uart_device)
@@ -83,5 +216,14 @@ uint8_t ReceiveUART(uart uart_device)
   return -1;
 }
 
+bool_t UARTReceiveReady(uart uart_device)
+{
+  if(uart_device == SERVO_CONTROLLER)
+    return (UCSR0A & (1<<RXC0)) ? TRUE : FALSE;
+  else if(uart_device == BLUETOOTH_MODULE)
+    return (UCSR1A & (1<<RXC1)) ? TRUE : FALSE;
+  return FALSE;
+}
+
 
 /** @} */ /* uart */
\ No newline at end of file
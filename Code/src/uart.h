@@ -13,6 +13,9 @@
  *
  * UART connects to the servo controller on PORTE 0 (RX) and to the bluetooth
  * module on PORTD 2 & 3.
+ *
+ * Transmitting does not wait for the wire.  Bytes go into a ring buffer per
+ * device which the data register empty interrupt drains in the background.
  */
  
 /* Used to prevent multiple inclusion of the header file */
@@ -51,12 +54,9 @@ void InitUART(uart uart_device, uint16_t ubrr);
 
 /** A function to transmit a byte over UART.  
  *  
- *	Contains two major blocks. One is for the Bluetooth module while the other 
- *  is for the servo controller.  If Bluetooth is selected as the device, UART0
- *  is loaded with the data and sent.  If the servo controller is selected,
- *  UART1 is loaded with the data and sent.  The function will hold until 
- *  the data register is empty. The device and byte of data are passed into this  
- *  function.
+ *	The byte is queued in the selected device's transmit ring and sent by the
+ *  data register empty interrupt.  The function only holds while the ring is
+ *  full. The device and byte of data are passed into this function.
  *  
  *	@par Parameters
  *  			-@a uart_device = selects the device to set-up (Bluetooth or
@@ -84,6 +84,64 @@ void TransmitUART(uart uart_device, uint8_t data);
  */
 uint8_t ReceiveUART(uart uart_device);
 
+/** A function to queue bytes for transmission without waiting.  Returns as
+ *  soon as the bytes are in the transmit ring.  Bytes that don't fit are not
+ *  queued.
+ *  
+ *	@par Parameters
+ *  			-@a uart_device = selects the device to send to (Bluetooth or
+ *								  servo controller)
+ *				-@a data = bytes to be sent
+ *				-@a length = number of bytes in data
+ *
+ * @returns
+ *			-Returns the number of bytes queued.
+ */
+uint8_t UartWrite(uart uart_device, uint8_t const* data, uint8_t length);
+
+/** A function that holds until every queued byte has been sent, including
+ *  the last one leaving the shift register.
+ *  
+ *	@par Parameters
+ *  			-@a uart_device = selects the device to flush (Bluetooth or
+ *								  servo controller)
+ */
+void UartFlush(uart uart_device);
+
+/** A function to check how many bytes UartWrite would take right now.  Used
+ *  to queue a packet whole or not at all.
+ *  
+ *	@par Parameters
+ *  			-@a uart_device = selects the device (Bluetooth or servo 
+ *								  controller)
+ * @returns
+ *			-Returns the number of free bytes in the transmit ring.
+ */
+uint8_t UartTxFree(uart uart_device);
+
+/** A function to read the high water mark of a transmit ring, used to size
+ *  the rings.
+ *  
+ *	@par Parameters
+ *  			-@a uart_device = selects the device (Bluetooth or servo 
+ *								  controller)
+ * @returns
+ *			-Returns the most bytes that have ever been waiting in the ring.
+ */
+uint8_t UartHighWater(uart uart_device);
+
+/** A function to check for a received byte without waiting for one.  Used
+ *  to read replies from the servo controller without blocking.
+ *  
+ *	@par Parameters
+ *  			-@a uart_device = selects the device to check (Bluetooth or
+ *								  servo controller)
+ * @returns
+ *			-Returns TRUE when ReceiveUART would return straight away.
+ *
+ */
+bool_t UARTReceiveReady(uart uart_device);
+
 
 #endif /* UART_H */
 /** @} */ /* uart */
\ No newline at end of file
@@ -37,6 +37,34 @@
 /*----------------------------------------------------------------------------*/
 #define MPU6050_I2C_ADDRESS 0x68 /* MPU-6050 Address */
 
+/* Sampling modes.  In data ready mode the INT pin of the MPU6050, wired to
+   PE4 (INT4), starts the read of every sample.  In FIFO mode the MPU6050 
+   queues the samples and its FIFO is read in bursts.  Either way the 
+   samples are averaged in groups of 2^MPU_DECIMATE_SHIFT before use. */
+#define MPU_MODE_FIFO        0
+#define MPU_MODE_DATA_READY  1
+#define MPU_SAMPLE_MODE      MPU_MODE_DATA_READY
+
+#define MPU_FIFO_PERIOD_MS  40  /* time between FIFO reads                 */
+#define MPU_FIFO_BATCH      8   /* most samples read in one burst          */
+#define MPU_DECIMATE_SHIFT  1   /* 125Hz sample rate / 2 = 62.5Hz out      */
+
+/*----------------------------------------------------------------------------*/
+/* INCLINE                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/* Mounting of the MPU6050: the accel axis pointing forward and the gyro 
+   axis the bike pitches about.  Both have to read positive nose up, negate
+   them otherwise. */
+#define INCLINE_FORWARD(s)      ((s)->accel_x)
+#define INCLINE_PITCH_RATE(s)   (-(s)->gyro_y)
+#define INCLINE_ACCEL_SHIFT     7   /* accel correction, 1/128 per sample, 2s */
+
+/* Automatic mode pre-shifts when the road climbs, gradients in percent */
+#define INCLINE_CLIMB_GRADE     4   /* cap the gears at the climbing gear    */
+#define INCLINE_STEEP_GRADE     8   /* cap the gears at the hill gear        */
+#define INCLINE_FLAT_GRADE      2   /* below this the caps are lifted        */
+
 /*----------------------------------------------------------------------------*/
 /* SERVOS                                                                     */
 /*----------------------------------------------------------------------------*/
@@ -45,6 +73,88 @@ typedef enum {FRONT_SERVO_CHANNEL = 0, REAR_SERVO_CHANNEL = 1} servoChannel_t;
 #define SERVO_RESET_PORT          PORTE
 #define SERVO_RESET_DDR           DDRE
 #define SERVO_RESET_PIN           2
+#define SERVO_MULTI_TARGET        1 /* 0 if the Maestro lacks Set Multiple
+                                       Targets (0x9F), like the Micro Maestro */
+
+/* The Maestro ramps each pulse at its speed limit (0.25us per 10ms, 0 for no
+   limit), so its moving state follows the servo.  Once it reports arrival a
+   step still waits its settle margin for the derailleur to come to rest. */
+#define SERVO_FRONT_SPEED         200
+#define SERVO_REAR_SPEED          200
+#define SERVO_FRONT_SETTLE_MS     400
+#define SERVO_REAR_SETTLE_MS      150
+
+/*----------------------------------------------------------------------------*/
+/* HALL EFFECT                                                                */
+/*----------------------------------------------------------------------------*/
+
+/* Measurement modes */
+#define HALL_MODE_WINDOW  0  /* count edges over the 1 second Timer1 window */
+#define HALL_MODE_PERIOD  1  /* time every edge with NowUs()                */
+#define HALL_MEASURE_MODE HALL_MODE_PERIOD
+
+#define TIRE_MAGNETS      4  /* magnets on the rear wheel spokes */
+#define PEDAL_MAGNETS     5  /* magnets on the inner pedal gear  */
+
+/*----------------------------------------------------------------------------*/
+/* DRIVETRAIN                                                                 */
+/*----------------------------------------------------------------------------*/
+
+/* Tooth counts, gear 1 is the smallest chainring and the smallest cog */
+#define CHAINRING_TEETH   {28, 38, 48}
+#define COG_TEETH         {14, 16, 18, 20, 22, 24, 28}
+#define WHEEL_MPH_PER_RPM 0.081439248  /* 2184mm rolling circumference */
+
+/* Rear gears usable on each chainring, bit 0 is rear gear 1.  The small 
+   ring skips the smallest cogs and the big ring the biggest ones, so the
+   chain is never crossed. */
+#define GEAR_USABLE       {0x7C, 0x7F, 0x1F}
+
+/* Automatic mode picks the gear that puts the cadence in this band, the 
+   app can change it.  A gear is kept until the cadence leaves the band by
+   more than the hysteresis. */
+#define CADENCE_LOW         70   /* rpm                                   */
+#define CADENCE_HIGH        90
+#define CADENCE_HYSTERESIS  5
+#define CADENCE_MIN         40   /* limits of a band the app may set      */
+#define CADENCE_MAX         150
+#define CADENCE_MIN_BAND    10
+
+/* Learning from manual mode, see learn.h.  Changes to the speed buckets
+   or the bins forget what was learned. */
+#define LEARN_BUCKET_MPH    2     /* 16 speeds cover 0 to 32mph            */
+#define LEARN_DELAY_MS      3000  /* after the last manual shift           */
+#define LEARN_MIN_SAMPLES   4     /* before a speed is used                */
+#define LEARN_SAVE_MINUTES  10    /* most often EEprom is written riding   */
+
+/*----------------------------------------------------------------------------*/
+/* PARKING                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/* After PARK_MINUTES without a tire edge the bike parks: the servo 
+   controller is held in reset, the MPU6050 drops to low power motion 
+   detection and the AtMega128 powers down until the MPU6050 feels motion. */
+#define PARK_MINUTES         5
+#define PARK_MOTION_THR      10  /* MOT_THR, 2mg per count                 */
+#define PARK_MOTION_DUR      1   /* MOT_DUR, 1ms per count                 */
+#define PARK_STARTUP_US      1000 /* oscillator start-up from power down, */
+                                  /* 16K CK with the crystal fuses        */
+
+/*----------------------------------------------------------------------------*/
+/* BUTTONS                                                                    */
+/*----------------------------------------------------------------------------*/
+
+/* Gesture timing.  Every button pressed before all are released again is 
+   part of the same chord, so a chord needs no exact timing. */
+#define BUTTON_HOLD_MS       800  /* a chord held this long is a hold       */
+#define BUTTON_DOUBLE_MS     300  /* most time from release to the 2nd tap  */
+
+/*----------------------------------------------------------------------------*/
+/* LED                                                                        */
+/*----------------------------------------------------------------------------*/
+#define LED_PORT             PORTE
+#define LED_DDR              DDRE
+#define LED_PIN              7
 
 
 
@@ -0,0 +1,145 @@
+/**
+ * @file   snapshot_test.c  <br>
+ * @brief  Host test of GetSensorSnapshot against torn reads. <br>
+ *
+ * Builds hall_effect.c on the host and runs GetSensorSnapshot one machine
+ * instruction at a time, using the x86 trap flag.  For every instruction in
+ * turn a hall effect update is injected right after it, the same writes the
+ * interrupts make, so the interrupt lands after every field of the copy.
+ * Each snapshot has to match the sensors before or after the update, a
+ * span from one and periods from the other is a torn read.
+ *
+ * Linux on x86-64 only, from Code/:
+ *
+ *     gcc -std=gnu99 -O0 -Wno-unknown-pragmas -Itest/stub -Isrc \
+ *         -D__interrupt= -D__monitor= -D__eeprom= -D__flash=const \
+ *         test/snapshot_test.c -o snapshot_test && ./snapshot_test
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include "../src/hall_effect.c"
+
+#define TRAP_FLAG  0x100UL
+
+/*----------------------------------------------------------------------------*/
+/* Stand-ins for the rest of the firmware                                     */
+/*----------------------------------------------------------------------------*/
+volatile uint8_t wakePending;
+volatile uint8_t parkWake;
+
+uint32_t NowUs(void)
+{
+  return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+/* Test data                                                                  */
+/*----------------------------------------------------------------------------*/
+/* Every mix of the two has its own speed and cadence */
+static const hall_raw before = {1000000, 1000000, 4, 5, FALSE, 7};
+static const hall_raw after  = {4000000, 250000,  8, 1, TRUE,  8};
+
+static volatile unsigned long steps;
+static volatile unsigned long injectAt;
+
+/* The writes of one hall effect interrupt, field by field like the ISRs */
+static void InjectUpdate(void)
+{
+  sensors.tireSpan = after.tireSpan;
+  sensors.pedalSpan = after.pedalSpan;
+  sensors.tirePeriods = after.tirePeriods;
+  sensors.pedalPeriods = after.pedalPeriods;
+  sensors.shiftFlag = after.shiftFlag;
+  sensors.sequence++;
+}
+
+static void OnStep(int sig, siginfo_t* info, void* context)
+{
+  (void)sig;
+  (void)info;
+  (void)context;
+  if(++steps == injectAt)
+    InjectUpdate();
+}
+
+static void SetSensors(const hall_raw* raw)
+{
+  sensors.tireSpan = raw->tireSpan;
+  sensors.pedalSpan = raw->pedalSpan;
+  sensors.tirePeriods = raw->tirePeriods;
+  sensors.pedalPeriods = raw->pedalPeriods;
+  sensors.shiftFlag = raw->shiftFlag;
+  sensors.sequence = raw->sequence;
+}
+
+static int SameSnapshot(const SensorSnapshot* a, const SensorSnapshot* b)
+{
+  return a->speed == b->speed && a->cadence == b->cadence
+         && a->tireTicks == b->tireTicks && a->shiftFlag == b->shiftFlag
+         && a->sequence == b->sequence;
+}
+
+/* Takes a snapshot with the update injected after instruction n */
+static void SteppedSnapshot(unsigned long n, SensorSnapshot* snapshot)
+{
+  steps = 0;
+  injectAt = n;
+  __asm__ volatile("pushfq; orq %0, (%%rsp); popfq" :: "i"(TRAP_FLAG) : "memory", "cc");
+  GetSensorSnapshot(snapshot);
+  __asm__ volatile("pushfq; andq %0, (%%rsp); popfq" :: "i"(~TRAP_FLAG) : "memory", "cc");
+}
+
+int main(void)
+{
+  struct sigaction action;
+  SensorSnapshot old;
+  SensorSnapshot new;
+  SensorSnapshot got;
+  unsigned long n;
+  unsigned long oldSeen = 0;
+  unsigned long newSeen = 0;
+  int failures = 0;
+
+  SetSensors(&before);
+  GetSensorSnapshot(&old);
+  SetSensors(&after);
+  GetSensorSnapshot(&new);
+  if(SameSnapshot(&old, &new))
+  {
+    printf("FAIL: test data does not tell the updates apart\n");
+    return 1;
+  }
+
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = OnStep;
+  action.sa_flags = SA_SIGINFO;
+  sigaction(SIGTRAP, &action, NULL);
+
+  for(n = 1; ; ++n)
+  {
+    SetSensors(&before);
+    SteppedSnapshot(n, &got);
+    if(steps < n)
+      break;  /* the snapshot finished before instruction n */
+
+    if(SameSnapshot(&got, &old))
+      oldSeen++;
+    else if(SameSnapshot(&got, &new))
+      newSeen++;
+    else
+    {
+      printf("FAIL: update after instruction %lu gave speed %u cadence %u "
+             "ticks %u\n", n, got.speed, got.cadence, got.tireTicks);
+      failures++;
+    }
+  }
+
+  printf("%lu injection points, %lu before, %lu after, %d torn\n",
+         n - 1, oldSeen, newSeen, failures);
+  return failures ? 1 : 0;
+}
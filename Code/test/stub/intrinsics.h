@@ -0,0 +1,8 @@
+/* Host stand-in for the IAR intrinsics, nothing runs in interrupts here */
+#ifndef INTRINSICS_H
+#define INTRINSICS_H
+
+#define __enable_interrupt()
+#define __disable_interrupt()
+
+#endif /* INTRINSICS_H */
@@ -0,0 +1,15 @@
+/* Host stand-in for the IAR device header, only the registers the code
+   under test touches. */
+#ifndef IOM128_H
+#define IOM128_H
+
+static volatile unsigned char EIMSK, EICRB, EIFR;
+
+#define INT5   5
+#define INT6   6
+#define ISC50  2
+#define ISC51  3
+#define ISC60  4
+#define ISC61  5
+
+#endif /* IOM128_H */
@@ -0,0 +1,113 @@
+#!/usr/bin/env python
+"""
+gen_shift_table.py - generates src/shift_table.h
+
+Builds the shortest legal path between every pair of the 21 (front, rear)
+gear states and writes it out as packed servo move codes for servos.c.
+
+Legal moves:
+  - the rear shifts one gear at a time from anywhere.
+  - the front shifts one gear at a time, only with the rear in its prep gear
+    (5 between front 1 and 2, 3 between front 2 and 3).  Every front move is
+    a pause, the front move itself and a rear trim.
+
+Paths are weighted by the servo wait of each step, so "shortest" is the
+quickest shift.  The codes only say which calibration table to use, the
+targets are looked up in servos.c while streaming, so recalibrating the 
+servo positions does not need a new table.  Re-run this script whenever the
+gear counts, prep gears or step waits below change:
+
+    python tools/gen_shift_table.py > src/shift_table.h
+"""
+import heapq
+
+FRONT_GEARS = 3
+REAR_GEARS = 7
+PREP_GEAR = {(1, 2): 5, (2, 3): 3}   # rear gear needed to cross the front pair
+
+# move codes, must match the MOVE_* defines in servos.c
+MOVE_END, MOVE_REAR_UP, MOVE_REAR_DOWN, MOVE_FRONT_UP, MOVE_FRONT_DOWN, \
+    MOVE_TRIM_UP, MOVE_TRIM_DOWN, MOVE_PAUSE = range(8)
+
+# ms waited by each step, must match the *_WAIT defines in servos.c
+REAR_STEP_WAIT = 500
+FRONT_STEP_WAIT = 1500
+PREP_PAUSE = 62
+
+
+def moves(front, rear):
+    """Yields (cost, codes, next state) for every legal move out of a state."""
+    if rear < REAR_GEARS:
+        yield REAR_STEP_WAIT, [MOVE_REAR_UP], (front, rear + 1)
+    if rear > 1:
+        yield REAR_STEP_WAIT, [MOVE_REAR_DOWN], (front, rear - 1)
+    if front < FRONT_GEARS and PREP_GEAR[(front, front + 1)] == rear:
+        yield (PREP_PAUSE + FRONT_STEP_WAIT + REAR_STEP_WAIT,
+               [MOVE_PAUSE, MOVE_FRONT_UP, MOVE_TRIM_UP], (front + 1, rear))
+    if front > 1 and PREP_GEAR[(front - 1, front)] == rear:
+        yield (PREP_PAUSE + FRONT_STEP_WAIT + REAR_STEP_WAIT,
+               [MOVE_PAUSE, MOVE_FRONT_DOWN, MOVE_TRIM_DOWN], (front - 1, rear))
+
+
+def shortest(start):
+    """Dijkstra from start, returns the move codes to reach every state."""
+    best = {start: (0, [])}
+    queue = [(0, [], start)]
+    while queue:
+        cost, path, state = heapq.heappop(queue)
+        if cost > best[state][0]:
+            continue
+        for step, codes, nxt in moves(*state):
+            if nxt not in best or cost + step < best[nxt][0]:
+                best[nxt] = (cost + step, path + codes)
+                heapq.heappush(queue, (cost + step, path + codes, nxt))
+    return dict((state, best[state][1]) for state in best)
+
+
+def main():
+    states = [(f, r) for f in range(1, FRONT_GEARS + 1)
+                     for r in range(1, REAR_GEARS + 1)]
+    paths = dict((s, shortest(s)) for s in states)
+    longest = max(len(p) for s in states for p in paths[s].values())
+    size = (longest + 2) // 2      # two codes per byte, room for MOVE_END
+
+    out = []
+    out.append("/**")
+    out.append(" * @file   shift_table.h  <br>")
+    out.append(" * @brief  Generated shift paths, do not edit. <br>")
+    out.append(" * @defgroup servos Servos")
+    out.append(" * @{")
+    out.append(" *")
+    out.append(" * Generated by tools/gen_shift_table.py.  Holds the quickest legal")
+    out.append(" * sequence of servo moves from every (front, rear) gear to every other.")
+    out.append(" * Indexed by [from][to] with a state of (front-1)*7 + (rear-1).  Two")
+    out.append(" * move codes are packed per byte, low nibble first, ending at MOVE_END.")
+    out.append(" */")
+    out.append("")
+    out.append("#ifndef SHIFT_TABLE_H")
+    out.append("#define SHIFT_TABLE_H")
+    out.append("")
+    out.append("#define SHIFT_STATES      %d" % len(states))
+    out.append("#define SHIFT_PATH_BYTES  %d" % size)
+    out.append("#define SHIFT_PATH_MOVES  %d /* longest path */" % longest)
+    out.append("")
+    out.append("static __flash const uint8_t shift_paths[SHIFT_STATES][SHIFT_STATES][SHIFT_PATH_BYTES] =")
+    out.append("{")
+    for i, s in enumerate(states):
+        out.append("  /* from %d,%d */" % s)
+        out.append("  {")
+        for j, t in enumerate(states):
+            codes = paths[s][t] + [MOVE_END] * (2 * size - len(paths[s][t]))
+            packed = [codes[k] | (codes[k + 1] << 4) for k in range(0, len(codes), 2)]
+            sep = "," if j < len(states) - 1 else ""
+            out.append("    {%s}%s /* to %d,%d */" % (",".join("0x%02X" % b for b in packed), sep, t[0], t[1]))
+        out.append("  }%s" % ("," if i < len(states) - 1 else ""))
+    out.append("};")
+    out.append("")
+    out.append("#endif /* SHIFT_TABLE_H */")
+    out.append("/** @} */ /* servos */")
+    print("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()